@@ -7,10 +7,11 @@ in vec2 TexCoord;
 in vec3 VertexColor;
 
 // Directional Light
+// Fields are paired so each float fills the slot after a vec3 (std140)
 struct DirectionalLight {
     vec3 direction;
-    vec3 color;
     float ambient;
+    vec3 color;
     float diffuse;
     float specular;
 };
@@ -18,18 +19,32 @@ struct DirectionalLight {
 // Point Light
 struct PointLight {
     vec3 position;
-    vec3 color;
     float constant;
+    vec3 color;
     float linear;
     float quadratic;
 };
 
-#define MAX_POINT_LIGHTS 4
+// Injected from rendering::LightsBlock::MAX_POINT_LIGHTS when the program is
+// compiled (see rendering::LightsBlockDefines)
+#ifndef MAX_POINT_LIGHTS
+#error MAX_POINT_LIGHTS must be defined by the host
+#endif
 
-uniform DirectionalLight u_DirLight;
-uniform int u_NumPointLights;
-uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
-uniform vec3 u_ViewPos;
+// Must match rendering::LightsBlock
+layout (std140, binding = 1) uniform Lights {
+    DirectionalLight u_DirLight;
+    PointLight u_PointLights[MAX_POINT_LIGHTS];
+    int u_NumPointLights;
+};
+
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
 uniform sampler2D u_DiffuseTexture;
 
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
@@ -75,7 +90,7 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
 void main()
 {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(u_ViewPos - FragPos);
+    vec3 viewDir = normalize(u_ViewPos.xyz - FragPos);
     
     // Directional lighting
     vec3 result = CalcDirectionalLight(u_DirLight, norm, viewDir);
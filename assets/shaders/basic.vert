@@ -10,13 +10,20 @@ out vec2 TexCoord;
 out vec3 VertexColor;
 
 uniform mat4 u_Model;      
-uniform mat4 u_View;       
-uniform mat4 u_Projection; 
+uniform mat3 u_NormalMatrix; // transpose(inverse(mat3(u_Model))), computed on the CPU
+
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
 
 void main()
 {
     FragPos = vec3(u_Model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(u_Model))) * aNormal;
+    Normal = u_NormalMatrix * aNormal;
     TexCoord = aTexCoord;
     VertexColor = aColor;
 
@@ -5,9 +5,14 @@ layout (location = 1) in vec3 aColor;
 out vec3 vColor;
 
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
 
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
 void main() {
     vColor = aColor;
     gl_Position = u_Projection * u_View * u_Model * vec4(aPos, 1.0);
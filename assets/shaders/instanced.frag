@@ -6,29 +6,57 @@ in vec3 Normal;
 in vec3 vColor;
 
 // Directional Light
+// Fields are paired so each float fills the slot after a vec3 (std140)
 struct DirectionalLight {
     vec3 direction;
-    vec3 color;
     float ambient;
+    vec3 color;
     float diffuse;
     float specular;
 };
 
-// Point Light
+// Point Light (see rendering::GpuClusterLight)
 struct PointLight {
     vec3 position;
+    float range;
     vec3 color;
     float constant;
     float linear;
     float quadratic;
 };
 
-#define MAX_POINT_LIGHTS 4
+// Leading part of rendering::LightsBlock; point lights come from the
+// cluster lists below instead of the block's forward array
+layout (std140, binding = 1) uniform Lights {
+    DirectionalLight u_DirLight;
+};
+
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
 
-uniform DirectionalLight u_DirLight;
-uniform int u_NumPointLights;
-uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
-uniform vec3 u_ViewPos;
+// Clustered lighting (see rendering::LightClusterGrid)
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+
+layout (std430, binding = 2) readonly buffer ClusterLights { PointLight u_Lights[]; };
+layout (std430, binding = 3) readonly buffer ClusterRanges { uvec2 u_ClusterRanges[]; }; // offset, count
+layout (std430, binding = 4) readonly buffer ClusterIndices { uint u_ClusterIndices[]; };
+
+uint ClusterIndex(vec3 fragPos) {
+    vec4 viewPos = u_View * vec4(fragPos, 1.0);
+    vec4 clip = u_Projection * viewPos;
+    vec2 uv = clip.xy / clip.w * 0.5 + 0.5;
+    uvec2 tile = uvec2(clamp(uv * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y), vec2(0.0), vec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1)));
+    float slice = floor(log(max(-viewPos.z, 1e-4)) * u_ClusterParams.x + u_ClusterParams.y);
+    uint z = uint(clamp(slice, 0.0, float(CLUSTER_SLICES - 1)));
+    return (z * CLUSTER_TILES_Y + tile.y) * CLUSTER_TILES_X + tile.x;
+}
 
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
     vec3 lightDir = normalize(-light.direction);
@@ -62,6 +90,10 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + 
                                light.quadratic * (distance * distance));
+
+    // Fade to zero at the light's range, so cluster edges never show a seam
+    float window = clamp(1.0 - pow(distance / light.range, 4.0), 0.0, 1.0);
+    attenuation *= window * window;
     
     vec3 ambient = 0.1 * light.color * attenuation;
     vec3 diffuse = diff * light.color * attenuation;
@@ -72,14 +104,15 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
 
 void main() {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(u_ViewPos - FragPos);
+    vec3 viewDir = normalize(u_ViewPos.xyz - FragPos);
     
     // Directional lighting
     vec3 result = CalcDirectionalLight(u_DirLight, norm, viewDir);
     
-    // Point lights
-    for(int i = 0; i < u_NumPointLights && i < MAX_POINT_LIGHTS; i++) {
-        result += CalcPointLight(u_PointLights[i], norm, FragPos, viewDir);
+    // Point lights binned into this fragment's cluster
+    uvec2 range = u_ClusterRanges[ClusterIndex(FragPos)];
+    for(uint i = 0u; i < range.y; i++) {
+        result += CalcPointLight(u_Lights[u_ClusterIndices[range.x + i]], norm, FragPos, viewDir);
     }
     
     // Apply to instance color
@@ -3,20 +3,34 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
-// Attributes 3-6 are the mat4 model matrix
-layout (location = 3) in mat4 aInstanceModel; 
-layout (location = 7) in vec3 aInstanceColor;
+// Packed per-instance tile data (see rendering::TileInstance)
+layout (location = 3) in ivec2 aInstanceXZ;
+layout (location = 4) in int aInstanceElevation;
+layout (location = 5) in uvec3 aInstanceTile; // type, autotile index, palette index
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 vColor;
 
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+// Injected from TownPresenter::PALETTE_SIZE when the program is compiled
+#ifndef PALETTE_SIZE
+#error PALETTE_SIZE must be defined by the host
+#endif
+
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
+uniform vec3 u_Palette[PALETTE_SIZE];
 
 void main() {
-    FragPos = vec3(aInstanceModel * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(aInstanceModel))) * aNormal;
-    vColor = aInstanceColor;
+    // Tiles are translated, never rotated or scaled, so normals pass through
+    vec3 offset = vec3(aInstanceXZ.x, aInstanceElevation, aInstanceXZ.y);
+    FragPos = aPos + offset;
+    Normal = aNormal;
+    vColor = u_Palette[min(aInstanceTile.z, uint(PALETTE_SIZE - 1))];
     gl_Position = u_Projection * u_View * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
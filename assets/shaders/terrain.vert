@@ -0,0 +1,23 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;    // World space, baked by TerrainMesher
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec3 aColor;
+
+// Same outputs as instanced.vert, so terrain shares instanced.frag
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 vColor;
+
+// Per-frame camera (see rendering::CameraBlock)
+layout (std140, binding = 0) uniform Camera {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams; // xy: log(depth) -> slice scale, bias
+};
+void main() {
+    FragPos = aPos;
+    Normal = aNormal;
+    vColor = aColor;
+    gl_Position = u_Projection * u_View * vec4(FragPos, 1.0);
+}
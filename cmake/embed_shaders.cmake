@@ -15,6 +15,8 @@ escape_shader_source(${INPUT_DEBUG_VERT} DEBUG_VERT_SOURCE)
 escape_shader_source(${INPUT_DEBUG_FRAG} DEBUG_FRAG_SOURCE)
 escape_shader_source(${INPUT_INSTANCED_VERT} INST_VERT_SOURCE)
 escape_shader_source(${INPUT_INSTANCED_FRAG} INST_FRAG_SOURCE)
+escape_shader_source(${INPUT_TERRAIN_VERT} TERRAIN_VERT_SOURCE)
+escape_shader_source(${INPUT_CULL_COMP} CULL_COMP_SOURCE)
 
 # Build the header content
 set(CONTENT "#pragma once\n\n")
@@ -30,6 +32,12 @@ set(CONTENT "${CONTENT}inline const char* embedded_debug_frag = \"${DEBUG_FRAG_S
 
 # Instanced shaders
 set(CONTENT "${CONTENT}inline const char* embedded_instanced_vert = \"${INST_VERT_SOURCE}\";\n\n")
-set(CONTENT "${CONTENT}inline const char* embedded_instanced_frag = \"${INST_FRAG_SOURCE}\";\n")
+set(CONTENT "${CONTENT}inline const char* embedded_instanced_frag = \"${INST_FRAG_SOURCE}\";\n\n")
+
+# Terrain mesh shader (fragment stage shared with the instanced shader)
+set(CONTENT "${CONTENT}inline const char* embedded_terrain_vert = \"${TERRAIN_VERT_SOURCE}\";\n\n")
+
+# GPU culling compute shader
+set(CONTENT "${CONTENT}inline const char* embedded_cull_comp = \"${CULL_COMP_SOURCE}\";\n")
 
 file(WRITE ${OUTPUT_HEADER} "${CONTENT}")
\ No newline at end of file
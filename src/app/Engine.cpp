@@ -5,6 +5,7 @@
 #include "platform/GlfwWindow.h"
 #include "rendering/opengl/OpenGLRenderer.h"
 #include "rendering/opengl/OpenGLInstancedMesh.h"
+#include "rendering/opengl/OpenGLTerrainMesh.h"
 #include "rendering/opengl/OpenGLShader.h"
 #include "rendering/opengl/OpenGLTexture.h"
 #include "rendering/opengl/PrimitiveData.h"
@@ -18,10 +19,15 @@
 #include "core/time/TimeSystem.h"
 #include "world/Town.h"
 #include "world/presentation/TownPresenter.h"
+#include "world/presentation/TerrainMesher.h"
+#include "world/presentation/TownImageExporter.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glad/glad.h>
+#include <iostream>
 #include <random>
+#include <string>
+#include <utility>
 
 namespace cozy::app
 {
@@ -45,12 +51,27 @@ namespace cozy::app
         const float *cubeData = rendering::primitives::CubeVertices;
         size_t floatCount = sizeof(rendering::primitives::CubeVertices) / sizeof(float);
         m_townMesh = std::make_unique<rendering::OpenGLInstancedMesh>(cubeData, floatCount);
+        m_terrainMesh = std::make_unique<rendering::OpenGLTerrainMesh>();
 
         // 3. Shader & Texture setup
         if (embedded_instanced_vert && embedded_instanced_frag)
-            m_instancedShader = std::make_unique<rendering::OpenGLShader>(embedded_instanced_vert, embedded_instanced_frag);
-        else
-            m_instancedShader = std::make_unique<rendering::OpenGLShader>();
+        {
+            const std::string instancedVert = rendering::OpenGLShader::WithDefines(
+                embedded_instanced_vert, "#define PALETTE_SIZE " + std::to_string(world::TownPresenter::PALETTE_SIZE) + "\n");
+            m_instancedShader = std::make_unique<rendering::OpenGLShader>(instancedVert.c_str(), embedded_instanced_frag);
+        }
+
+        // Tile colours are constant, so the palette is uploaded once
+        if (m_instancedShader)
+        {
+            const auto palette = world::TownPresenter::BuildPalette();
+            m_instancedShader->Bind();
+            for (int i = 0; i < world::TownPresenter::PALETTE_SIZE; ++i)
+                m_instancedShader->SetVec3("u_Palette[" + std::to_string(i) + "]", palette[i]);
+        }
+
+        if (embedded_terrain_vert && embedded_instanced_frag)
+            m_terrainShader = std::make_unique<rendering::OpenGLShader>(embedded_terrain_vert, embedded_instanced_frag);
 
         m_testTexture = std::make_unique<rendering::OpenGLTexture>("placeholder.jpg");
 
@@ -74,7 +95,15 @@ namespace cozy::app
         sun.ambient = 0.2f;
         sun.diffuse = 0.8f;
         sun.specular = 0.3f;
+        if (m_nightMode)
+        {
+            sun.color = glm::vec3(0.45f, 0.55f, 0.9f) * 0.6f; // Moonlight
+            sun.ambient = 0.1f;
+            sun.diffuse = 0.3f;
+            sun.specular = 0.05f;
+        }
         m_lightManager->SetDirectionalLight(sun);
+        m_lightManager->ClearPointLights();
 
         rendering::PointLight light1;
         light1.position = glm::vec3(45.0f, 10.0f, 45.0f);
@@ -83,6 +112,50 @@ namespace cozy::app
         light1.linear = 0.09f;
         light1.quadratic = 0.032f;
         m_lightManager->AddPointLight(light1);
+
+        if (m_nightMode && m_town)
+            PlaceLampPosts();
+    }
+
+    void Engine::PlaceLampPosts()
+    {
+        // Every LAMP_SPACING tiles on open land; a few hundred lights per town
+        constexpr int LAMP_SPACING = 6;
+        for (int wz = LAMP_SPACING / 2; wz < world::Town::TILES_Z; wz += LAMP_SPACING)
+        {
+            for (int wx = LAMP_SPACING / 2; wx < world::Town::TILES_X; wx += LAMP_SPACING)
+            {
+                const world::Tile tile = std::as_const(*m_town).TileAt(wx, wz);
+                if (tile.type != world::TileType::GRASS && tile.type != world::TileType::DIRT &&
+                    tile.type != world::TileType::SAND)
+                    continue;
+
+                rendering::PointLight lamp;
+                lamp.position = glm::vec3(static_cast<float>(wx), tile.elevation + 2.0f, static_cast<float>(wz));
+                lamp.color = glm::vec3(1.0f, 0.75f, 0.4f) * 1.5f;
+                lamp.constant = 1.0f;
+                lamp.linear = 0.7f;
+                lamp.quadratic = 1.8f;
+                m_lightManager->AddPointLight(lamp);
+            }
+        }
+        std::cout << "[Engine] Night: " << m_lightManager->GetPointLights().size() << " point lights" << std::endl;
+    }
+
+    void Engine::DumpTown() const
+    {
+        world::TownPresenter::DebugDump(*m_town);
+
+        const std::string path = "town_" + std::to_string(m_town->GetSeed()) + ".png";
+        try
+        {
+            world::TownImageExporter::Write(*m_town, path);
+            std::cout << "[Engine] Town image written to " << path << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[Engine] " << e.what() << std::endl;
+        }
     }
 
     void Engine::RegenerateTown()
@@ -95,13 +168,115 @@ namespace cozy::app
         // Logic: Town handles the generation
         m_town->Generate(randomSeed, config);
 
-        // Presentation: TownPresenter extracts the render data
-        auto instances = world::TownPresenter::GenerateRenderData(*m_town);
+        // Presentation: a fresh town is dirty everywhere
+        SyncRenderData();
+
+        // Lamp posts follow the new terrain
+        if (m_nightMode)
+            SetupLighting();
+
+        auto stats = world::TerrainMesher::ComputeStats(m_terrainChunks);
+        std::cout << "[Engine] Terrain mesh (" << (m_meshingStrategy == world::MeshingStrategy::Greedy ? "greedy" : "per-face")
+                  << "): " << stats.quads << " quads, " << stats.triangles << " triangles in " << stats.chunks
+                  << " chunks (instanced cubes: " << m_instances.size() * 12 << " triangles)" << std::endl;
+    }
+
+    void Engine::SyncRenderData()
+    {
+        const world::Town::AcreMask &dirty = m_town->DirtyAcres();
+        if (dirty.none())
+            return;
+
+        // Instances and culling bounds: rewrite the dirty acres and upload
+        // each run of adjacent dirty acres as one contiguous range
+        if (m_instances.empty())
+        {
+            m_instances = world::TownPresenter::GenerateRenderData(*m_town);
+            m_batches = world::TownPresenter::GenerateBatches(*m_town);
+            if (m_townMesh)
+            {
+                m_townMesh->UpdateInstances(m_instances);
+                m_townMesh->SetBatches(m_batches);
+            }
+        }
+        else
+        {
+            world::TownPresenter::UpdateRenderData(*m_town, dirty, m_instances);
+            world::TownPresenter::UpdateBatches(*m_town, dirty, m_batches);
+            for (int first = 0; first < world::Town::ACRE_COUNT && m_townMesh;)
+            {
+                if (!dirty.test(first))
+                {
+                    ++first;
+                    continue;
+                }
+
+                int end = first + 1;
+                while (end < world::Town::ACRE_COUNT && dirty.test(end))
+                    ++end;
+                m_townMesh->UpdateInstanceRange(m_instances, world::TownPresenter::AcreInstanceOffset(first),
+                                                world::TownPresenter::AcreInstanceOffset(end) - world::TownPresenter::AcreInstanceOffset(first));
+                m_townMesh->UpdateBatchRange(m_batches, first, end - first);
+                first = end;
+            }
+        }
+
+        // Terrain: remesh the affected chunks only
+        if (m_terrainChunks.empty())
+        {
+            m_terrainChunks = world::TerrainMesher::BuildTown(*m_town, m_meshingStrategy);
+            if (m_terrainMesh)
+                m_terrainMesh->Upload(m_terrainChunks);
+        }
+        else
+        {
+            const world::Town::AcreMask rebuilt = world::TerrainMesher::RebuildDirty(*m_town, dirty, m_terrainChunks, m_meshingStrategy);
+            for (int acre = 0; acre < world::Town::ACRE_COUNT && m_terrainMesh; ++acre)
+            {
+                if (rebuilt.test(acre))
+                    m_terrainMesh->UploadChunk(acre, m_terrainChunks[acre]);
+            }
+        }
+
+        m_town->ClearDirtyAcres();
+    }
 
-        if (m_townMesh)
+    void Engine::CycleCullingMode()
+    {
+        switch (m_renderer->GetCullingMode())
         {
-            m_townMesh->UpdateInstances(instances);
+        case rendering::CullingMode::None:
+            m_renderer->SetCullingMode(rendering::CullingMode::Cpu);
+            break;
+        case rendering::CullingMode::Cpu:
+            m_renderer->SetCullingMode(rendering::CullingMode::Gpu);
+            break;
+        case rendering::CullingMode::Gpu:
+            m_renderer->SetCullingMode(rendering::CullingMode::None);
+            break;
         }
+        m_titleDirty = true;
+    }
+
+    void Engine::UpdateTitleStats()
+    {
+        const rendering::RenderStats &stats = m_renderer->GetFrameStats();
+        if (!m_titleDirty && stats.acresVisible == m_lastStats.acresVisible &&
+            stats.acresCulled == m_lastStats.acresCulled && stats.drawCalls == m_lastStats.drawCalls)
+            return;
+
+        m_lastStats = stats;
+        m_titleDirty = false;
+
+        const char *mode = "none";
+        if (m_renderer->GetCullingMode() == rendering::CullingMode::Cpu)
+            mode = "cpu";
+        else if (m_renderer->GetCullingMode() == rendering::CullingMode::Gpu)
+            mode = "gpu";
+
+        m_window->SetTitle(platform::WindowConfig::Default().title + " | culling " + mode + " | acres drawn " +
+                           std::to_string(stats.acresVisible) + "/" + std::to_string(stats.acresVisible + stats.acresCulled) +
+                           " (" + std::to_string(stats.acresCulled) + " culled, " + std::to_string(stats.drawCalls) + " draws)");
     }
 
     void Engine::Run()
@@ -116,25 +291,49 @@ namespace cozy::app
             if (m_input->IsActionTriggered(core::InputAction::Regenerate))
                 RegenerateTown();
 
+            // Picks up any tile edits made since the last frame
+            SyncRenderData();
+
             if (m_input->IsActionTriggered(core::InputAction::ToggleDebug))
                 m_showDebugGizmos = !m_showDebugGizmos;
 
+            if (m_input->IsActionTriggered(core::InputAction::ToggleTerrain))
+                m_useTerrainMesh = !m_useTerrainMesh;
+
+            if (m_input->IsActionTriggered(core::InputAction::CycleCulling))
+                CycleCullingMode();
+
+            if (m_input->IsActionTriggered(core::InputAction::ToggleNight))
+            {
+                m_nightMode = !m_nightMode;
+                SetupLighting();
+            }
+
+            if (m_input->IsActionTriggered(core::InputAction::DumpTown))
+                DumpTown();
+
             m_renderer->BeginFrame();
+            m_renderer->UpdateFrameUniforms(*m_camera, m_lightManager.get());
 
-            if (m_townMesh && m_instancedShader)
+            if (m_useTerrainMesh && m_terrainMesh && m_terrainShader)
+            {
+                m_renderer->DrawTerrain(*m_terrainMesh, *m_terrainShader, *m_camera);
+            }
+            else if (m_townMesh && m_instancedShader)
             {
                 m_renderer->BindTexture(*m_testTexture, 0);
-                m_renderer->DrawInstanced(*m_townMesh, *m_instancedShader, *m_camera, m_lightManager.get());
+                m_renderer->DrawInstanced(*m_townMesh, *m_instancedShader, *m_camera);
             }
 
             if (m_showDebugGizmos && m_debugGizmos && m_debugShader)
             {
                 glDisable(GL_DEPTH_TEST);
-                m_debugGizmos->RenderLightGizmos(*m_lightManager, *m_debugShader, *m_camera);
+                m_debugGizmos->RenderLightGizmos(*m_lightManager, *m_debugShader);
                 glEnable(GL_DEPTH_TEST);
             }
 
             m_renderer->EndFrame();
+            UpdateTitleStats();
             m_window->SwapBuffers();
             m_window->PollEvents();
         }
@@ -3,6 +3,10 @@
 #include <vector>
 #include "world/Town.h"
 #include "world/data/TownConfig.h"
+#include "world/presentation/TerrainMesher.h"
+#include "rendering/InstanceData.h"
+#include "rendering/TerrainMeshData.h"
+#include "rendering/RenderStats.h"
 
 namespace cozy::platform
 {
@@ -21,6 +25,7 @@ namespace cozy::rendering
     class OpenGLShader;
     class OpenGLTexture;
     class OpenGLInstancedMesh;
+    class OpenGLTerrainMesh;
     class LightManager;
     namespace debug
     {
@@ -45,6 +50,17 @@ namespace cozy::app
         std::unique_ptr<rendering::OpenGLInstancedMesh> m_townMesh;
         std::unique_ptr<rendering::OpenGLShader> m_instancedShader;
 
+        // Chunked terrain (visible faces only); toggled against the instanced cubes
+        std::unique_ptr<rendering::OpenGLTerrainMesh> m_terrainMesh;
+        std::unique_ptr<rendering::OpenGLShader> m_terrainShader;
+        bool m_useTerrainMesh{true};
+        world::MeshingStrategy m_meshingStrategy{world::MeshingStrategy::Greedy};
+
+        // CPU copies of the uploaded render data, refreshed per dirty acre
+        std::vector<rendering::TileInstance> m_instances;
+        std::vector<rendering::InstanceBatch> m_batches; // One per acre, indexed by Town::AcreIndex
+        std::vector<rendering::TerrainChunk> m_terrainChunks;
+
         // Test objects
         std::unique_ptr<rendering::OpenGLTexture> m_testTexture;
 
@@ -56,9 +72,21 @@ namespace cozy::app
         std::unique_ptr<core::IShader> m_debugShader;
         bool m_showDebugGizmos{false};
 
+        // Night scene: dimmed sun plus a lamp post light on a grid of land tiles
+        bool m_nightMode{false};
+
+        // Culling stats shown in the window title (updated when they change)
+        rendering::RenderStats m_lastStats;
+        bool m_titleDirty{true};
+
         // Helper methods
         void RegenerateTown();
+        void SyncRenderData();
+        void UpdateTitleStats();
+        void CycleCullingMode();
         void SetupLighting();
+        void PlaceLampPosts();
+        void DumpTown() const;
 
     public:
         Engine();
@@ -33,6 +33,7 @@ namespace cozy::core
     {
     public:
         virtual void SetMat4(const std::string &name, const glm::mat4 &mat) const = 0;
+        virtual void SetMat3(const std::string &name, const glm::mat3 &mat) const = 0;
         virtual void SetVec3(const std::string &name, const glm::vec3 &val) const = 0;
         virtual void SetInt(const std::string &name, int val) const = 0;
         virtual void SetFloat(const std::string &name, float val) const = 0;
@@ -18,7 +18,11 @@ namespace cozy::core
         Regenerate,
         Exit,
         ToggleCursor,
-        ToggleDebug
+        ToggleDebug,
+        ToggleTerrain,
+        CycleCulling,
+        ToggleNight,
+        DumpTown
     };
 
     class IInputSystem
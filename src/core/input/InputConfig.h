@@ -17,6 +17,10 @@ namespace cozy::core
         int keyToggleCursor{258}; // TAB
         int keyRegenerate{82};    // R
         int keyToggleDebug{96};   // `
+        int keyToggleTerrain{77}; // M
+        int keyCycleCulling{67};  // C
+        int keyToggleNight{78};   // N
+        int keyDumpTown{80};      // P
 
         int keySprint{340}; // LEFT_SHIFT
         int keyZoomIn{81};  // Q
@@ -16,6 +16,10 @@ namespace cozy::core
         updateActionState(window, InputAction::Exit, m_config.keyExit);
         updateActionState(window, InputAction::ToggleCursor, m_config.keyToggleCursor);
         updateActionState(window, InputAction::ToggleDebug, m_config.keyToggleDebug);
+        updateActionState(window, InputAction::ToggleTerrain, m_config.keyToggleTerrain);
+        updateActionState(window, InputAction::CycleCulling, m_config.keyCycleCulling);
+        updateActionState(window, InputAction::ToggleNight, m_config.keyToggleNight);
+        updateActionState(window, InputAction::DumpTown, m_config.keyDumpTown);
 
         // 2. Handle Continuous Systems
         handleKeyboard(window, camera, deltaTime);
@@ -0,0 +1,43 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+
+namespace cozy::rendering
+{
+    // View frustum as six inward-facing planes, extracted from a combined
+    // projection * view matrix (Gribb/Hartmann). Used to skip acres and
+    // chunks that cannot be on screen.
+    class Frustum
+    {
+    public:
+        explicit Frustum(const glm::mat4 &viewProjection)
+        {
+            // glm is column-major: row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+            auto row = [&](int i)
+            { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+            const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+            m_planes = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2}; // L, R, B, T, N, F
+        }
+
+        // Conservative: true unless the box is entirely behind some plane
+        bool IntersectsBox(const glm::vec3 &min, const glm::vec3 &max) const
+        {
+            for (const glm::vec4 &plane : m_planes)
+            {
+                // The box corner furthest along the plane normal
+                const glm::vec3 p(plane.x >= 0.0f ? max.x : min.x,
+                                  plane.y >= 0.0f ? max.y : min.y,
+                                  plane.z >= 0.0f ? max.z : min.z);
+                if (plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        const std::array<glm::vec4, 6> &GetPlanes() const { return m_planes; }
+
+    private:
+        std::array<glm::vec4, 6> m_planes;
+    };
+}
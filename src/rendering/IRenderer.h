@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include "rendering/RenderStats.h"
 #include <cstdint>
 
 namespace cozy::core
@@ -13,6 +14,7 @@ namespace cozy::core
 namespace cozy::rendering
 {
     class OpenGLInstancedMesh;
+    class OpenGLTerrainMesh;
     class LightManager;
 
     class IRenderer
@@ -25,19 +27,35 @@ namespace cozy::rendering
         virtual void EndFrame() = 0;
         virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 
+        // Writes the camera and light uniform blocks shared by every shader.
+        // Call once per frame after BeginFrame, before any draw; lights are
+        // re-uploaded only when the LightManager has changed.
+        virtual void UpdateFrameUniforms(const core::ICamera &camera, const LightManager *lights = nullptr) = 0;
+
         virtual void DrawMesh(
             const core::IMesh &mesh,
             const core::IShader &shader,
-            const glm::mat4 &modelMatrix,
-            const core::ICamera &camera) = 0;
+            const glm::mat4 &modelMatrix) = 0;
 
-        // Added optional lights parameter
+        // The camera is used for culling; its matrices come from the frame uniforms
         virtual void DrawInstanced(
             const OpenGLInstancedMesh &mesh,
             const core::IShader &shader,
-            const core::ICamera &camera,
-            const LightManager *lights = nullptr) = 0;
+            const core::ICamera &camera) = 0;
+
+        virtual void DrawTerrain(
+            const OpenGLTerrainMesh &mesh,
+            const core::IShader &shader,
+            const core::ICamera &camera) = 0;
 
         virtual void BindTexture(const core::ITexture &texture, uint32_t slot = 0) = 0;
+
+        // Culling applied by DrawInstanced (terrain chunks fall back to CPU
+        // culling under Gpu, as they are separate buffers)
+        virtual void SetCullingMode(CullingMode mode) = 0;
+        [[nodiscard]] virtual CullingMode GetCullingMode() const noexcept = 0;
+
+        // Counters for the frame since the last BeginFrame
+        [[nodiscard]] virtual const RenderStats &GetFrameStats() const noexcept = 0;
     };
 }
\ No newline at end of file
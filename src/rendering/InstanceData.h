@@ -1,12 +1,32 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace cozy::rendering
 {
+    // Per-tile instance record, 8 bytes. Tiles sit on the integer grid with
+    // translation only, so the vertex shader rebuilds the position from x/z and
+    // the elevation, and looks the colour up in the palette the presenter
+    // uploads (see TownPresenter::BuildPalette).
     struct TileInstance
     {
-        glm::mat4 modelMatrix;
-        glm::vec3 color;
-        float padding; // Keep 16-byte alignment for performance
+        int16_t x;
+        int16_t z;
+        int8_t elevation;
+        uint8_t type; // world::TileType
+        uint8_t autotileIndex;
+        uint8_t paletteIndex;
     };
-}
\ No newline at end of file
+
+    static_assert(sizeof(TileInstance) == 8, "TileInstance must stay tightly packed");
+
+    // A contiguous run of instances (one acre) and the world-space box that
+    // encloses all of its cubes, for frustum culling
+    struct InstanceBatch
+    {
+        uint32_t first;
+        uint32_t count;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+}
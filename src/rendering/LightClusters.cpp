@@ -0,0 +1,172 @@
+#include "rendering/LightClusters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace cozy::rendering
+{
+    namespace
+    {
+        // Fraction of full brightness below which a light is treated as out of range
+        constexpr float RANGE_CUTOFF = 1.0f / 128.0f;
+
+        bool SphereIntersectsBox(const glm::vec3 &center, float radius, const glm::vec3 &min, const glm::vec3 &max)
+        {
+            const glm::vec3 closest = glm::clamp(center, min, max);
+            const glm::vec3 d = closest - center;
+            return glm::dot(d, d) <= radius * radius;
+        }
+    }
+
+    float LightClusterGrid::ComputeRange(const PointLight &light)
+    {
+        // Solve brightness / (c + l*d + q*d^2) = cutoff for d
+        const float brightness = std::max({light.color.x, light.color.y, light.color.z, 0.0f});
+        const float target = brightness / RANGE_CUTOFF - light.constant;
+        if (target <= 0.0f)
+            return 0.0f;
+        if (light.quadratic <= 0.0f)
+            return light.linear > 0.0f ? target / light.linear : 0.0f;
+
+        const float disc = light.linear * light.linear + 4.0f * light.quadratic * target;
+        return (-light.linear + std::sqrt(disc)) / (2.0f * light.quadratic);
+    }
+
+    glm::vec2 LightClusterGrid::SliceParams(float nearPlane, float farPlane)
+    {
+        const float scale = static_cast<float>(SLICES) / std::log(farPlane / nearPlane);
+        return {scale, -std::log(nearPlane) * scale};
+    }
+
+    void LightClusterGrid::BuildClusterBounds(const glm::mat4 &projection, float nearPlane, float farPlane)
+    {
+        m_projection = projection;
+        m_near = nearPlane;
+        m_far = farPlane;
+
+        m_sliceDepths.resize(SLICES + 1);
+        for (int s = 0; s <= SLICES; ++s)
+            m_sliceDepths[s] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(s) / SLICES);
+
+        // View-space point on the ray through an NDC position, at a given depth
+        const glm::mat4 inverseProjection = glm::inverse(projection);
+        auto pointAt = [&](float ndcX, float ndcY, float depth)
+        {
+            glm::vec4 p = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+            const glm::vec3 onRay = glm::vec3(p) / p.w;
+            return onRay * (depth / -onRay.z);
+        };
+
+        m_bounds.resize(CLUSTER_COUNT);
+        for (int s = 0; s < SLICES; ++s)
+        {
+            for (int ty = 0; ty < TILES_Y; ++ty)
+            {
+                for (int tx = 0; tx < TILES_X; ++tx)
+                {
+                    const float x0 = -1.0f + 2.0f * tx / TILES_X;
+                    const float x1 = -1.0f + 2.0f * (tx + 1) / TILES_X;
+                    const float y0 = -1.0f + 2.0f * ty / TILES_Y;
+                    const float y1 = -1.0f + 2.0f * (ty + 1) / TILES_Y;
+
+                    Bounds &b = m_bounds[ClusterIndex(tx, ty, s)];
+                    b.min = glm::vec3(std::numeric_limits<float>::max());
+                    b.max = glm::vec3(-std::numeric_limits<float>::max());
+                    for (float depth : {m_sliceDepths[s], m_sliceDepths[s + 1]})
+                    {
+                        for (const glm::vec3 &corner : {pointAt(x0, y0, depth), pointAt(x1, y0, depth),
+                                                        pointAt(x0, y1, depth), pointAt(x1, y1, depth)})
+                        {
+                            b.min = glm::min(b.min, corner);
+                            b.max = glm::max(b.max, corner);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void LightClusterGrid::Build(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane,
+                                 const std::vector<PointLight> &lights)
+    {
+        if (m_bounds.empty() || nearPlane != m_near || farPlane != m_far ||
+            std::memcmp(&projection, &m_projection, sizeof(glm::mat4)) != 0)
+            BuildClusterBounds(projection, nearPlane, farPlane);
+
+        m_lights.clear();
+        m_hits.clear();
+        m_ranges.assign(CLUSTER_COUNT, ClusterRange{0, 0});
+
+        for (const PointLight &light : lights)
+        {
+            const float range = ComputeRange(light);
+            if (range <= 0.0f)
+                continue;
+
+            const uint32_t lightIndex = static_cast<uint32_t>(m_lights.size());
+            m_lights.push_back({light.position, range, light.color, light.constant, light.linear, light.quadratic, {0.0f, 0.0f}});
+
+            const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            const float nearest = -center.z - range;
+            const float farthest = -center.z + range;
+            if (farthest < m_near || nearest > m_far)
+                continue;
+
+            // Slices the sphere's depth span touches
+            const int firstSlice = static_cast<int>(std::upper_bound(m_sliceDepths.begin(), m_sliceDepths.end(), nearest) - m_sliceDepths.begin()) - 1;
+            const int lastSlice = static_cast<int>(std::lower_bound(m_sliceDepths.begin(), m_sliceDepths.end(), farthest) - m_sliceDepths.begin()) - 1;
+
+            for (int s = std::max(firstSlice, 0); s <= std::min(lastSlice, SLICES - 1); ++s)
+            {
+                // With a symmetric projection a tile's x extent depends only on
+                // its column and its y extent only on its row, so the first
+                // row/column narrow the candidates before the exact test
+                int tx0 = 0;
+                int tx1 = TILES_X - 1;
+                while (tx0 <= tx1 && m_bounds[ClusterIndex(tx0, 0, s)].max.x < center.x - range)
+                    ++tx0;
+                while (tx1 >= tx0 && m_bounds[ClusterIndex(tx1, 0, s)].min.x > center.x + range)
+                    --tx1;
+                int ty0 = 0;
+                int ty1 = TILES_Y - 1;
+                while (ty0 <= ty1 && m_bounds[ClusterIndex(0, ty0, s)].max.y < center.y - range)
+                    ++ty0;
+                while (ty1 >= ty0 && m_bounds[ClusterIndex(0, ty1, s)].min.y > center.y + range)
+                    --ty1;
+
+                for (int ty = ty0; ty <= ty1; ++ty)
+                {
+                    for (int tx = tx0; tx <= tx1; ++tx)
+                    {
+                        const int cluster = ClusterIndex(tx, ty, s);
+                        const Bounds &b = m_bounds[cluster];
+                        if (!SphereIntersectsBox(center, range, b.min, b.max))
+                            continue;
+
+                        ++m_ranges[cluster].count;
+                        m_hits.push_back(static_cast<uint32_t>(cluster));
+                        m_hits.push_back(lightIndex);
+                    }
+                }
+            }
+        }
+
+        // Counting sort by cluster: each cluster's lights end up contiguous and
+        // in submission order
+        uint32_t offset = 0;
+        for (ClusterRange &range : m_ranges)
+        {
+            range.offset = offset;
+            offset += range.count;
+            range.count = 0;
+        }
+
+        m_indices.resize(offset);
+        for (size_t i = 0; i < m_hits.size(); i += 2)
+        {
+            ClusterRange &range = m_ranges[m_hits[i]];
+            m_indices[range.offset + range.count++] = m_hits[i + 1];
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "rendering/Light.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cozy::rendering
+{
+    // Storage buffer bindings for clustered lighting. 0 and 1 are taken by
+    // the GPU culling pass (see cull.comp).
+    constexpr uint32_t CLUSTER_LIGHTS_BINDING = 2;
+    constexpr uint32_t CLUSTER_RANGES_BINDING = 3;
+    constexpr uint32_t CLUSTER_INDICES_BINDING = 4;
+
+    // std430 mirror of the clustered point light (world space)
+    struct GpuClusterLight
+    {
+        glm::vec3 position;
+        float range; // Beyond this the light contributes nothing
+        glm::vec3 color;
+        float constant;
+        float linear;
+        float quadratic;
+        float pad[2];
+    };
+
+    // A cluster's slice of the light index list
+    struct ClusterRange
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    static_assert(sizeof(GpuClusterLight) == 48, "GpuClusterLight must match std430");
+    static_assert(sizeof(ClusterRange) == 8, "ClusterRange must match std430");
+
+    /**
+     * @brief Bins point lights into view-space clusters for forward shading
+     *
+     * The view frustum is split into TILES_X x TILES_Y screen tiles and SLICES
+     * depth slices, spaced exponentially so near clusters stay small. Each
+     * frame, every light's sphere of influence is tested against the clusters
+     * it can reach, and each cluster gets a range of a shared light index list.
+     * Fragments then shade only the lights listed for their cluster, so the
+     * cost per fragment follows local light density, not the scene total.
+     */
+    class LightClusterGrid
+    {
+    public:
+        // Must match the CLUSTER_* defines in instanced.frag
+        static constexpr int TILES_X = 16;
+        static constexpr int TILES_Y = 9;
+        static constexpr int SLICES = 24;
+        static constexpr int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+        static constexpr int ClusterIndex(int tx, int ty, int slice) { return (slice * TILES_Y + ty) * TILES_X + tx; }
+
+        // Distance at which the attenuated light falls below a dim cutoff;
+        // the shader windows its falloff to reach zero exactly there
+        static float ComputeRange(const PointLight &light);
+
+        // Maps log(view depth) to a slice: slice = floor(log(depth) * x + y)
+        static glm::vec2 SliceParams(float nearPlane, float farPlane);
+
+        /**
+         * @brief Rebuild the cluster light lists for this frame
+         * @param view World-to-view matrix
+         * @param projection Symmetric perspective projection
+         * @param nearPlane,farPlane Depth range the slices cover
+         */
+        void Build(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane,
+                   const std::vector<PointLight> &lights);
+
+        const std::vector<GpuClusterLight> &GetLights() const { return m_lights; }
+        const std::vector<ClusterRange> &GetRanges() const { return m_ranges; }
+        const std::vector<uint32_t> &GetIndices() const { return m_indices; }
+
+    private:
+        struct Bounds
+        {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        // Recomputed only when the projection or depth range changes
+        void BuildClusterBounds(const glm::mat4 &projection, float nearPlane, float farPlane);
+
+        glm::mat4 m_projection{0.0f};
+        float m_near{0.0f};
+        float m_far{0.0f};
+        std::vector<Bounds> m_bounds; // View space, per cluster
+        std::vector<float> m_sliceDepths; // SLICES + 1 boundaries, positive distances
+
+        std::vector<GpuClusterLight> m_lights;
+        std::vector<ClusterRange> m_ranges;
+        std::vector<uint32_t> m_indices;
+        std::vector<uint32_t> m_hits; // (cluster, light) pairs, packed before sorting
+    };
+}
@@ -1,5 +1,4 @@
 #include "rendering/LightManager.h"
-#include "core/graphics/IGpuResource.h"
 #include <algorithm>
 
 namespace cozy::rendering
@@ -17,6 +16,7 @@ namespace cozy::rendering
     void LightManager::SetDirectionalLight(const DirectionalLight &light)
     {
         m_directionalLight = light;
+        ++m_version;
     }
 
     void LightManager::AddPointLight(const PointLight &light)
@@ -24,12 +24,14 @@ namespace cozy::rendering
         if (m_pointLights.size() < MAX_POINT_LIGHTS)
         {
             m_pointLights.push_back(light);
+            ++m_version;
         }
     }
 
     void LightManager::ClearPointLights()
     {
         m_pointLights.clear();
+        ++m_version;
     }
 
     void LightManager::RemovePointLight(size_t index)
@@ -37,35 +39,33 @@ namespace cozy::rendering
         if (index < m_pointLights.size())
         {
             m_pointLights.erase(m_pointLights.begin() + index);
+            ++m_version;
         }
     }
 
-    void LightManager::ApplyToShader(const core::IShader &shader, const glm::vec3 &viewPos) const
+    void LightManager::FillBlock(LightsBlock &block) const
     {
-        // Bind camera position for specular calculations
-        shader.SetVec3("u_ViewPos", viewPos);
+        block = LightsBlock{};
 
-        // Bind directional light
-        shader.SetVec3("u_DirLight.direction", m_directionalLight.direction);
-        shader.SetVec3("u_DirLight.color", m_directionalLight.color);
-        shader.SetFloat("u_DirLight.ambient", m_directionalLight.ambient);
-        shader.SetFloat("u_DirLight.diffuse", m_directionalLight.diffuse);
-        shader.SetFloat("u_DirLight.specular", m_directionalLight.specular);
+        block.dirLight.direction = m_directionalLight.direction;
+        block.dirLight.color = m_directionalLight.color;
+        block.dirLight.ambient = m_directionalLight.ambient;
+        block.dirLight.diffuse = m_directionalLight.diffuse;
+        block.dirLight.specular = m_directionalLight.specular;
 
-        // Bind point lights
-        int numLights = static_cast<int>(std::min(m_pointLights.size(), MAX_POINT_LIGHTS));
-        shader.SetInt("u_NumPointLights", numLights);
+        int numLights = static_cast<int>(std::min<size_t>(m_pointLights.size(), LightsBlock::MAX_POINT_LIGHTS));
+        block.numPointLights = numLights;
 
         for (int i = 0; i < numLights; ++i)
         {
-            std::string base = "u_PointLights[" + std::to_string(i) + "]";
             const PointLight &light = m_pointLights[i];
+            GpuPointLight &out = block.pointLights[i];
 
-            shader.SetVec3(base + ".position", light.position);
-            shader.SetVec3(base + ".color", light.color);
-            shader.SetFloat(base + ".constant", light.constant);
-            shader.SetFloat(base + ".linear", light.linear);
-            shader.SetFloat(base + ".quadratic", light.quadratic);
+            out.position = light.position;
+            out.color = light.color;
+            out.constant = light.constant;
+            out.linear = light.linear;
+            out.quadratic = light.quadratic;
         }
     }
 }
\ No newline at end of file
@@ -1,17 +1,14 @@
 #pragma once
 #include "rendering/Light.h"
+#include "rendering/UniformBlocks.h"
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
-namespace cozy::core
-{
-    class IShader;
-}
-
 namespace cozy::rendering
 {
     /**
-     * @brief Manages all scene lights and applies them to shaders
+     * @brief Manages all scene lights and packs them for the lights uniform block
      */
     class LightManager
     {
@@ -25,20 +22,26 @@ namespace cozy::rendering
         void RemovePointLight(size_t index);
 
         /**
-         * @brief Apply all lights to the given shader
-         * @param shader The shader to receive light uniforms
-         * @param viewPos Camera position for specular calculations
+         * @brief Write the sun and the first LightsBlock::MAX_POINT_LIGHTS point lights into the Lights block
+         * @param block Destination, uploaded by the renderer in one write
+         */
+        void FillBlock(LightsBlock &block) const;
+
+        /**
+         * @brief Bumped on every change, so the renderer re-uploads only when lights move
          */
-        void ApplyToShader(const core::IShader &shader, const glm::vec3 &viewPos) const;
+        [[nodiscard]] uint64_t GetVersion() const noexcept { return m_version; }
 
         // Getters
         const DirectionalLight &GetDirectionalLight() const { return m_directionalLight; }
         const std::vector<PointLight> &GetPointLights() const { return m_pointLights; }
 
-        static constexpr size_t MAX_POINT_LIGHTS = 4;
+        // Clustered shading keeps per-fragment cost independent of this
+        static constexpr size_t MAX_POINT_LIGHTS = 4096;
 
     private:
         DirectionalLight m_directionalLight;
         std::vector<PointLight> m_pointLights;
+        uint64_t m_version{0};
     };
 }
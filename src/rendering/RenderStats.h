@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace cozy::rendering
+{
+    enum class CullingMode
+    {
+        None, // Submit every acre
+        Cpu,  // Frustum-test acre bounds on the CPU, draw visible ranges
+        Gpu   // Compute shader writes indirect draws; no CPU work per acre
+    };
+
+    // Per-frame counters, reset by IRenderer::BeginFrame. GPU culling is never
+    // read back, so its acres count as neither visible nor culled.
+    struct RenderStats
+    {
+        uint32_t drawCalls = 0;
+        uint32_t acresVisible = 0; // Acre batches / terrain chunks submitted
+        uint32_t acresCulled = 0;  // Rejected by the frustum test
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace cozy::rendering
+{
+    struct TerrainVertex
+    {
+        glm::vec3 position; // World space
+        glm::vec3 normal;
+        glm::vec3 color;
+    };
+
+    // Indexed triangle list for one acre. An acre has at most 256 tiles with a
+    // top and four sides each, so 16-bit indices always suffice.
+    struct TerrainChunk
+    {
+        int acreX = 0;
+        int acreZ = 0;
+        glm::vec3 boundsMin{0.0f}; // World-space box enclosing every vertex
+        glm::vec3 boundsMax{0.0f};
+        std::vector<TerrainVertex> vertices;
+        std::vector<uint16_t> indices;
+
+        size_t TriangleCount() const { return indices.size() / 3; }
+        size_t QuadCount() const { return indices.size() / 6; } // Chunks are built from quads only
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cozy::rendering
+{
+    // CPU mirrors of the std140 uniform blocks shared by every shader. The
+    // renderer binds one buffer per block to these fixed binding points and
+    // rewrites it once per frame; shaders declare the matching
+    // `layout (std140, binding = N)` blocks.
+    //
+    // std140 aligns a vec3 to 16 bytes but lets a float fill the slot after
+    // it, so fields are ordered vec3/float pairs and glm::vec3 (12 bytes) lines
+    // up without manual padding.
+    constexpr uint32_t CAMERA_BLOCK_BINDING = 0;
+    constexpr uint32_t LIGHTS_BLOCK_BINDING = 1;
+
+    struct CameraBlock
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 viewPos;       // xyz used
+        glm::vec4 clusterParams; // xy: LightClusterGrid::SliceParams
+    };
+
+    struct GpuDirectionalLight
+    {
+        glm::vec3 direction;
+        float ambient;
+        glm::vec3 color;
+        float diffuse;
+        float specular;
+        float pad[3];
+    };
+
+    struct GpuPointLight
+    {
+        glm::vec3 position;
+        float constant;
+        glm::vec3 color;
+        float linear;
+        float quadratic;
+        float pad[3];
+    };
+
+    // Forward lighting data. Point lights here are the first few only, for
+    // shaders without clustered lighting (basic.frag); instanced.frag reads
+    // every light through the cluster buffers (see LightClusters.h).
+    struct LightsBlock
+    {
+        // Injected into basic.frag as a #define (see LightsBlockDefines)
+        static constexpr int MAX_POINT_LIGHTS = 4;
+
+        GpuDirectionalLight dirLight;
+        GpuPointLight pointLights[MAX_POINT_LIGHTS];
+        int32_t numPointLights;
+        int32_t pad[3];
+    };
+
+    static_assert(sizeof(CameraBlock) == 160, "CameraBlock must match the std140 Camera block");
+    static_assert(sizeof(GpuDirectionalLight) == 48 && sizeof(GpuPointLight) == 48, "light structs must match std140");
+    static_assert(offsetof(LightsBlock, pointLights) == 48, "LightsBlock must match the std140 Lights block");
+    static_assert(offsetof(LightsBlock, numPointLights) == 240, "LightsBlock must match the std140 Lights block");
+
+    // #define lines for OpenGLShader::WithDefines when compiling a shader that
+    // declares the Lights block with its point light array (basic.frag)
+    inline std::string LightsBlockDefines()
+    {
+        return "#define MAX_POINT_LIGHTS " + std::to_string(LightsBlock::MAX_POINT_LIGHTS) + "\n";
+    }
+}
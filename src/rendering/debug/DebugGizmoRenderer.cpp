@@ -4,7 +4,6 @@
 #include "rendering/LightManager.h"
 #include "rendering/Light.h"
 #include "core/graphics/IGpuResource.h"
-#include "core/camera/ICamera.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glad/glad.h>
 
@@ -28,19 +27,13 @@ namespace cozy::rendering::debug
 
     void DebugGizmoRenderer::RenderLightGizmos(
         const LightManager &lights,
-        const core::IShader &shader,
-        const core::ICamera &camera)
+        const core::IShader &shader)
     {
         if (!m_enabled)
             return;
 
         shader.Bind();
 
-        // TODO: Pass aspect ratio from outside
-        float aspect = 1280.0f / 720.0f;
-        shader.SetMat4("u_View", camera.GetViewMatrix());
-        shader.SetMat4("u_Projection", camera.GetProjectionMatrix(aspect));
-
         RenderDirectionalLight(lights.GetDirectionalLight(), shader);
 
         for (const auto &light : lights.GetPointLights())
@@ -5,7 +5,6 @@
 namespace cozy::core
 {
     class IShader;
-    class ICamera;
 }
 namespace cozy::rendering
 {
@@ -24,10 +23,10 @@ namespace cozy::rendering::debug
         DebugGizmoRenderer();
         ~DebugGizmoRenderer();
 
+        // Camera matrices come from the frame uniform block
         void RenderLightGizmos(
             const LightManager &lights,
-            const core::IShader &shader,
-            const core::ICamera &camera);
+            const core::IShader &shader);
 
         void SetEnabled(bool enabled) { m_enabled = enabled; }
         void SetDirectionalLightLength(float length) { m_dirLightLength = length; }
@@ -1,5 +1,10 @@
 #include "OpenGLInstancedMesh.h"
-#include <glad/glad.h>
+#include "OpenGLShader.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
 namespace cozy::rendering
 {
@@ -9,7 +14,6 @@ namespace cozy::rendering
 
         glGenVertexArrays(1, &m_VAO);
         glGenBuffers(1, &m_VBO);
-        glGenBuffers(1, &m_InstanceVBO);
 
         glBindVertexArray(m_VAO);
 
@@ -25,45 +29,278 @@ namespace cozy::rendering
         glEnableVertexAttribArray(2); // Tex
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void *)(6 * sizeof(float)));
 
-        // 2. Dynamic Instance Data (Model Matrix and Color)
-        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+        // 2. Dynamic Instance Data is attached by AllocateRing on the first update
+        glBindVertexArray(0);
+    }
 
-        // Matrix takes 4 attribute slots (locations 3, 4, 5, 6)
-        GLsizei instanceStride = (GLsizei)sizeof(TileInstance);
-        for (int i = 0; i < 4; i++)
+    void OpenGLInstancedMesh::UpdateInstances(const std::vector<TileInstance> &instances)
+    {
+        if (instances.size() > m_RegionCapacity)
+            AllocateRing(instances.size());
+
+        m_Shadow = instances;
+        m_InstanceCount = instances.size();
+        m_Pending = true;
+    }
+
+    void OpenGLInstancedMesh::UpdateInstanceRange(const std::vector<TileInstance> &instances, size_t first, size_t count)
+    {
+        if (count == 0)
+            return;
+        std::copy(instances.begin() + first, instances.begin() + first + count, m_Shadow.begin() + first);
+        m_Pending = true;
+    }
+
+    void OpenGLInstancedMesh::SetBatches(std::vector<InstanceBatch> batches)
+    {
+        m_Batches = std::move(batches);
+
+        std::vector<GpuBatch> gpuBatches;
+        gpuBatches.reserve(m_Batches.size());
+        for (const InstanceBatch &batch : m_Batches)
+            gpuBatches.push_back(ToGpuBatch(batch));
+
+        if (!m_BatchSSBO)
         {
-            glEnableVertexAttribArray(3 + i);
-            glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, instanceStride, (void *)(sizeof(float) * i * 4));
-            glVertexAttribDivisor(3 + i, 1); // Tell OpenGL this updates per instance, not per vertex
+            glGenBuffers(1, &m_BatchSSBO);
+            glGenBuffers(1, &m_IndirectBuffer);
         }
 
-        // Color (location 7)
-        glEnableVertexAttribArray(7);
-        glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, instanceStride, (void *)offsetof(TileInstance, color));
-        glVertexAttribDivisor(7, 1);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_BatchSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, gpuBatches.size() * sizeof(GpuBatch), gpuBatches.data(), GL_DYNAMIC_DRAW);
 
-        glBindVertexArray(0);
+        // Written by the culling pass only (4 uints per command)
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_IndirectBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, m_Batches.size() * 4 * sizeof(uint32_t), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     }
 
-    void OpenGLInstancedMesh::UpdateInstances(const std::vector<TileInstance> &instances)
+    void OpenGLInstancedMesh::UpdateBatchRange(const std::vector<InstanceBatch> &batches, size_t first, size_t count)
     {
-        m_InstanceCount = instances.size();
-        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
-        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(TileInstance), instances.data(), GL_DYNAMIC_DRAW);
+        if (count == 0)
+            return;
+
+        std::vector<GpuBatch> gpuBatches;
+        gpuBatches.reserve(count);
+        for (size_t i = first; i < first + count; ++i)
+        {
+            m_Batches[i] = batches[i];
+            gpuBatches.push_back(ToGpuBatch(batches[i]));
+        }
+
+        // The SSBO keeps its size, so only the changed slots are rewritten
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_BatchSSBO);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, (GLintptr)(first * sizeof(GpuBatch)),
+                        (GLsizeiptr)(count * sizeof(GpuBatch)), gpuBatches.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void OpenGLInstancedMesh::Draw(const Frustum *frustum, RenderStats *stats) const
+    {
+        if (m_InstanceCount == 0)
+            return;
+        if (m_Pending)
+            Publish();
+
+        glBindVertexArray(m_VAO);
+        if (m_Batches.empty())
+        {
+            DrawRange(0, (uint32_t)m_InstanceCount, stats);
+        }
+        else
+        {
+            // Extend the pending run while visible batches stay contiguous
+            uint32_t runFirst = 0, runCount = 0;
+            for (const InstanceBatch &batch : m_Batches)
+            {
+                if (frustum && !frustum->IntersectsBox(batch.boundsMin, batch.boundsMax))
+                {
+                    if (stats)
+                        stats->acresCulled++;
+                    continue;
+                }
+                if (stats)
+                    stats->acresVisible++;
+
+                if (runCount > 0 && batch.first == runFirst + runCount)
+                {
+                    runCount += batch.count;
+                    continue;
+                }
+                DrawRange(runFirst, runCount, stats);
+                runFirst = batch.first;
+                runCount = batch.count;
+            }
+            DrawRange(runFirst, runCount, stats);
+        }
+
+        FenceRegion();
+    }
+
+    void OpenGLInstancedMesh::CullOnGpu(const OpenGLShader &cullShader, const Frustum &frustum) const
+    {
+        if (m_InstanceCount == 0 || m_Batches.empty())
+            return;
+        // The commands bake in the ring region, so publish first
+        if (m_Pending)
+            Publish();
+
+        // One invocation per batch
+        const uint32_t batchCount = (uint32_t)m_Batches.size();
+        cullShader.Bind();
+        const auto &planes = frustum.GetPlanes();
+        cullShader.SetVec4Array("u_Planes", planes.data(), static_cast<int>(planes.size()));
+        cullShader.SetUint("u_BatchCount", batchCount);
+        cullShader.SetUint("u_VertexCount", (uint32_t)m_VertexCount);
+        cullShader.SetUint("u_BaseInstance", (uint32_t)(m_Region * m_RegionCapacity));
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_BatchSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_IndirectBuffer);
+        glDispatchCompute((batchCount + 63) / 64, 1, 1);
+
+        // The commands must be visible to the indirect fetch
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
     }
 
-    void OpenGLInstancedMesh::Draw() const
+    void OpenGLInstancedMesh::DrawIndirect(RenderStats *stats) const
     {
         if (m_InstanceCount == 0)
             return;
+        if (m_Batches.empty())
+        {
+            Draw(nullptr, stats);
+            return;
+        }
+
+        glBindVertexArray(m_VAO);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+        glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, (GLsizei)m_Batches.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        if (stats)
+            stats->drawCalls++;
+
+        FenceRegion();
+    }
+
+    void OpenGLInstancedMesh::FenceRegion() const
+    {
+        // Guard the region until the draws reading it have completed
+        if (m_Fences[m_Region])
+            glDeleteSync(m_Fences[m_Region]);
+        m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void OpenGLInstancedMesh::DrawRange(uint32_t first, uint32_t count, RenderStats *stats) const
+    {
+        if (count == 0)
+            return;
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, (GLsizei)m_VertexCount, (GLsizei)count,
+                                          (GLuint)(m_Region * m_RegionCapacity + first));
+        if (stats)
+            stats->drawCalls++;
+    }
+
+    void OpenGLInstancedMesh::Publish() const
+    {
+        const int next = (m_Region + 1) % RING_REGIONS;
+
+        // Only blocks if the GPU is still RING_REGIONS - 1 draws behind
+        if (GLsync fence = m_Fences[next])
+        {
+            GLenum status;
+            do
+            {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+            } while (status == GL_TIMEOUT_EXPIRED);
+            glDeleteSync(fence);
+            m_Fences[next] = nullptr;
+        }
+
+        // The mapping is coherent, so the writes are visible to later draws without a flush
+        std::memcpy(m_Mapped + next * m_RegionCapacity, m_Shadow.data(), m_InstanceCount * sizeof(TileInstance));
+        m_Region = next;
+        m_Pending = false;
+    }
+
+    OpenGLInstancedMesh::GpuBatch OpenGLInstancedMesh::ToGpuBatch(const InstanceBatch &batch)
+    {
+        return {glm::vec4(batch.boundsMin, 0.0f), glm::vec4(batch.boundsMax, 0.0f), batch.first, batch.count, {0, 0}};
+    }
+
+    void OpenGLInstancedMesh::AllocateRing(size_t regionCapacity)
+    {
+        ReleaseRing();
+        m_RegionCapacity = regionCapacity;
+
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr bytes = (GLsizeiptr)(RING_REGIONS * regionCapacity * sizeof(TileInstance));
+
+        glGenBuffers(1, &m_InstanceVBO);
         glBindVertexArray(m_VAO);
-        glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)m_VertexCount, (GLsizei)m_InstanceCount);
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+        glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        m_Mapped = static_cast<TileInstance *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+        if (!m_Mapped)
+        {
+            // Publish writes through the mapping, so there is nothing to fall back to
+            glBindVertexArray(0);
+            glDeleteBuffers(1, &m_InstanceVBO);
+            m_InstanceVBO = 0;
+            m_RegionCapacity = 0;
+            throw std::runtime_error("Failed to map the tile instance ring buffer (" + std::to_string(bytes) + " bytes)");
+        }
+
+        // Packed TileInstance, integer attributes
+        GLsizei instanceStride = (GLsizei)sizeof(TileInstance);
+
+        // Grid position (location 3)
+        glEnableVertexAttribArray(3);
+        glVertexAttribIPointer(3, 2, GL_SHORT, instanceStride, (void *)offsetof(TileInstance, x));
+        glVertexAttribDivisor(3, 1); // Tell OpenGL this updates per instance, not per vertex
+
+        // Elevation (location 4)
+        glEnableVertexAttribArray(4);
+        glVertexAttribIPointer(4, 1, GL_BYTE, instanceStride, (void *)offsetof(TileInstance, elevation));
+        glVertexAttribDivisor(4, 1);
+
+        // Type, autotile index and palette index (location 5)
+        glEnableVertexAttribArray(5);
+        glVertexAttribIPointer(5, 3, GL_UNSIGNED_BYTE, instanceStride, (void *)offsetof(TileInstance, type));
+        glVertexAttribDivisor(5, 1);
+
+        glBindVertexArray(0);
+    }
+
+    void OpenGLInstancedMesh::ReleaseRing()
+    {
+        for (GLsync &fence : m_Fences)
+        {
+            if (fence)
+                glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if (m_InstanceVBO)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glDeleteBuffers(1, &m_InstanceVBO);
+        }
+        m_InstanceVBO = 0;
+        m_Mapped = nullptr;
+        m_RegionCapacity = 0;
+        m_Region = 0;
     }
 
     OpenGLInstancedMesh::~OpenGLInstancedMesh()
     {
+        ReleaseRing();
+        if (m_BatchSSBO)
+        {
+            glDeleteBuffers(1, &m_BatchSSBO);
+            glDeleteBuffers(1, &m_IndirectBuffer);
+        }
         glDeleteVertexArrays(1, &m_VAO);
         glDeleteBuffers(1, &m_VBO);
-        glDeleteBuffers(1, &m_InstanceVBO);
     }
-}
\ No newline at end of file
+}
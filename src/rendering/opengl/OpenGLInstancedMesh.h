@@ -1,22 +1,93 @@
 #pragma once
 #include "core/graphics/IGpuResource.h"
 #include "rendering/InstanceData.h"
+#include "rendering/Frustum.h"
+#include "rendering/RenderStats.h"
+#include <glad/glad.h>
+#include <array>
 #include <vector>
 
 namespace cozy::rendering
 {
+    class OpenGLShader;
+
+    // Instanced cube mesh whose per-tile instances stream through a persistently
+    // mapped ring: RING_REGIONS copies of the instance array in one immutable
+    // buffer. Updates land in a CPU shadow copy; the next Draw publishes it into
+    // the region after the current one (waiting on that region's fence only if
+    // the GPU is still reading it) and draws from there with a base instance.
     class OpenGLInstancedMesh
     {
     public:
+        static constexpr int RING_REGIONS = 3;
+
         OpenGLInstancedMesh(const float *vertices, size_t vertexCount);
         ~OpenGLInstancedMesh();
 
+        OpenGLInstancedMesh(const OpenGLInstancedMesh &) = delete;
+        OpenGLInstancedMesh &operator=(const OpenGLInstancedMesh &) = delete;
+
+        // Replaces all instances; the ring is reallocated only when it is too small
         void UpdateInstances(const std::vector<TileInstance> &instances);
-        void Draw() const;
+
+        // Replaces instances [first, first + count); instances.size() must match
+        // the last UpdateInstances call
+        void UpdateInstanceRange(const std::vector<TileInstance> &instances, size_t first, size_t count);
+
+        // Culling granularity: batches must be sorted by `first`. With no
+        // batches, every instance is drawn unculled.
+        // Also mirrored into the SSBO read by the GPU culling pass.
+        void SetBatches(std::vector<InstanceBatch> batches);
+
+        // Replaces batches [first, first + count) in place, bounds included;
+        // batches.size() must match the last SetBatches call
+        void UpdateBatchRange(const std::vector<InstanceBatch> &batches, size_t first, size_t count);
+
+        // Draws the batches that intersect `frustum` (all when null), merging
+        // adjacent visible batches into one draw call
+        void Draw(const Frustum *frustum = nullptr, RenderStats *stats = nullptr) const;
+
+        // GPU-driven path. CullOnGpu dispatches `cullShader` (cull.comp), which
+        // tests every batch against `frustum` and writes one indirect command
+        // per batch; DrawIndirect then submits them all with a single
+        // glMultiDrawArraysIndirect under the caller's draw shader. CPU cost
+        // does not grow with the batch count.
+        void CullOnGpu(const OpenGLShader &cullShader, const Frustum &frustum) const;
+        void DrawIndirect(RenderStats *stats = nullptr) const;
 
     private:
-        uint32_t m_VAO, m_VBO, m_InstanceVBO;
+        void AllocateRing(size_t regionCapacity);
+        void ReleaseRing();
+        void Publish() const;
+        void DrawRange(uint32_t first, uint32_t count, RenderStats *stats) const;
+        void FenceRegion() const;
+
+        // std430 layout of one InstanceBatch in the culling SSBO (see cull.comp)
+        struct GpuBatch
+        {
+            glm::vec4 boundsMin;
+            glm::vec4 boundsMax;
+            uint32_t first;
+            uint32_t count;
+            uint32_t pad[2];
+        };
+        static_assert(sizeof(GpuBatch) == 48, "GpuBatch must match the std430 layout");
+        static GpuBatch ToGpuBatch(const InstanceBatch &batch);
+
+        uint32_t m_VAO, m_VBO, m_InstanceVBO{0};
         size_t m_VertexCount;
         size_t m_InstanceCount = 0;
+
+        size_t m_RegionCapacity = 0;        // Instances per ring region
+        TileInstance *m_Mapped = nullptr;   // Persistent, coherent mapping of every region
+        std::vector<TileInstance> m_Shadow; // Latest instance data, published on the next Draw
+        std::vector<InstanceBatch> m_Batches;
+        uint32_t m_BatchSSBO{0};
+        uint32_t m_IndirectBuffer{0}; // One DrawArraysIndirectCommand per batch
+
+        // Publishing and fencing happen at draw time
+        mutable int m_Region = 0;
+        mutable bool m_Pending = false;
+        mutable std::array<GLsync, RING_REGIONS> m_Fences{};
     };
-}
\ No newline at end of file
+}
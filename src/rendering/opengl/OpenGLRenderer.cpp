@@ -1,13 +1,76 @@
 #include "rendering/opengl/OpenGLRenderer.h"
 #include "rendering/opengl/OpenGLInstancedMesh.h"
+#include "rendering/opengl/OpenGLTerrainMesh.h"
+#include "rendering/opengl/OpenGLShader.h"
 #include "rendering/LightManager.h"
+#include "rendering/UniformBlocks.h"
+#include "rendering/LightClusters.h"
 #include "core/graphics/IGpuResource.h"
 #include "core/camera/ICamera.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <iostream>
+#include <vector>
+#include "shaders_embedded.h"
 
 namespace cozy::rendering
 {
+    namespace
+    {
+        // Inverse-transpose of the model's linear part, computed once per draw
+        // instead of once per vertex. Translation-only models (the common case)
+        // leave normals untouched.
+        glm::mat3 ComputeNormalMatrix(const glm::mat4 &model)
+        {
+            const glm::mat3 linear(model);
+            if (linear == glm::mat3(1.0f))
+                return linear;
+            return glm::transpose(glm::inverse(linear));
+        }
+
+        // Storage buffers start non-empty so their bindings are always valid
+        constexpr size_t MIN_STORAGE_BYTES = 16;
+
+        uint32_t CreateStorageBuffer(uint32_t binding, size_t &capacity)
+        {
+            uint32_t buffer = 0;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, MIN_STORAGE_BYTES, nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+            capacity = MIN_STORAGE_BYTES;
+            return buffer;
+        }
+
+        // Writes `bytes` at the start of the buffer, doubling its storage when
+        // it is too small (the binding follows the buffer name, so it survives)
+        void UploadStorage(uint32_t buffer, size_t &capacity, const void *data, size_t bytes)
+        {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+            if (bytes > capacity)
+            {
+                capacity = std::max(bytes, capacity * 2);
+                glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+            }
+            if (bytes > 0)
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bytes, data);
+        }
+    }
+
+    OpenGLRenderer::OpenGLRenderer()
+        : m_clusters(std::make_unique<LightClusterGrid>())
+    {
+    }
+
+    OpenGLRenderer::~OpenGLRenderer()
+    {
+        for (uint32_t buffer : {m_cameraUBO, m_lightsUBO, m_clusterLightsSSBO, m_clusterRangesSSBO, m_clusterIndicesSSBO})
+        {
+            if (buffer)
+                glDeleteBuffers(1, &buffer);
+        }
+    }
+
     void OpenGLRenderer::Initialize(void *)
     {
         if (!gladLoadGL())
@@ -21,10 +84,77 @@ namespace cozy::rendering
         glCullFace(GL_BACK);
         glFrontFace(GL_CCW);
         std::cout << "[OpenGLRenderer] Context initialized (CCW Winding)" << std::endl;
+
+        if (embedded_cull_comp)
+            m_cullShader = std::make_unique<OpenGLShader>(embedded_cull_comp);
+
+        // Shaders pick the blocks up through their binding qualifiers, so the
+        // buffers are bound once here and never rebound
+        glGenBuffers(1, &m_cameraUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, m_cameraUBO);
+
+        glGenBuffers(1, &m_lightsUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BLOCK_BINDING, m_lightsUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        m_clusterLightsSSBO = CreateStorageBuffer(CLUSTER_LIGHTS_BINDING, m_clusterLightsCapacity);
+        m_clusterRangesSSBO = CreateStorageBuffer(CLUSTER_RANGES_BINDING, m_clusterRangesCapacity);
+        m_clusterIndicesSSBO = CreateStorageBuffer(CLUSTER_INDICES_BINDING, m_clusterIndicesCapacity);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void OpenGLRenderer::UpdateFrameUniforms(const core::ICamera &camera, const LightManager *lights)
+    {
+        float aspect = 1280.0f / 720.0f; // TODO: Pull from window config
+        const float nearPlane = camera.GetConfig().nearPlane;
+        const float farPlane = camera.GetConfig().farPlane;
+
+        CameraBlock cameraBlock;
+        cameraBlock.view = camera.GetViewMatrix();
+        cameraBlock.projection = camera.GetProjectionMatrix(aspect);
+        cameraBlock.viewPos = glm::vec4(camera.GetPosition(), 1.0f);
+        const glm::vec2 sliceParams = LightClusterGrid::SliceParams(nearPlane, farPlane);
+        cameraBlock.clusterParams = glm::vec4(sliceParams.x, sliceParams.y, 0.0f, 0.0f);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &cameraBlock);
+
+        // Clusters follow the camera, so the light lists are rebuilt every frame
+        static const std::vector<PointLight> noLights;
+        m_clusters->Build(cameraBlock.view, cameraBlock.projection, nearPlane, farPlane,
+                          lights ? lights->GetPointLights() : noLights);
+
+        // A fresh LightManager starts at version 0, so compare the pointer too
+        if (lights && (lights != m_uploadedLights || lights->GetVersion() != m_uploadedLightsVersion))
+        {
+            LightsBlock lightsBlock;
+            lights->FillBlock(lightsBlock);
+            glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUBO);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightsBlock), &lightsBlock);
+
+            const std::vector<GpuClusterLight> &clusterLights = m_clusters->GetLights();
+            UploadStorage(m_clusterLightsSSBO, m_clusterLightsCapacity, clusterLights.data(),
+                          clusterLights.size() * sizeof(GpuClusterLight));
+
+            m_uploadedLights = lights;
+            m_uploadedLightsVersion = lights->GetVersion();
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        const std::vector<ClusterRange> &ranges = m_clusters->GetRanges();
+        const std::vector<uint32_t> &indices = m_clusters->GetIndices();
+        UploadStorage(m_clusterRangesSSBO, m_clusterRangesCapacity, ranges.data(), ranges.size() * sizeof(ClusterRange));
+        UploadStorage(m_clusterIndicesSSBO, m_clusterIndicesCapacity, indices.data(), indices.size() * sizeof(uint32_t));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     }
 
     void OpenGLRenderer::BeginFrame()
     {
+        m_stats = RenderStats{};
         glClearColor(0.45f, 0.7f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
@@ -32,14 +162,11 @@ namespace cozy::rendering
     void OpenGLRenderer::DrawMesh(
         const core::IMesh &mesh,
         const core::IShader &shader,
-        const glm::mat4 &modelMatrix,
-        const core::ICamera &camera)
+        const glm::mat4 &modelMatrix)
     {
         shader.Bind();
         shader.SetMat4("u_Model", modelMatrix);
-        shader.SetMat4("u_View", camera.GetViewMatrix());
-        float aspect = 1280.0f / 720.0f; // TODO: Pull from window config
-        shader.SetMat4("u_Projection", camera.GetProjectionMatrix(aspect));
+        shader.SetMat3("u_NormalMatrix", ComputeNormalMatrix(modelMatrix));
         glBindVertexArray(mesh.GetRendererID());
         glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mesh.GetVertexCount());
         glBindVertexArray(0);
@@ -48,22 +175,35 @@ namespace cozy::rendering
     void OpenGLRenderer::DrawInstanced(
         const OpenGLInstancedMesh &mesh,
         const core::IShader &shader,
-        const core::ICamera &camera,
-        const LightManager *lights)
+        const core::ICamera &camera)
     {
+        float aspect = 1280.0f / 720.0f;
+        const Frustum frustum(camera.GetProjectionMatrix(aspect) * camera.GetViewMatrix());
+        const bool gpuCulling = m_cullingMode == CullingMode::Gpu && m_cullShader;
+
+        // The culling pass uses its own program, so it runs before the draw shader is bound
+        if (gpuCulling)
+            mesh.CullOnGpu(*m_cullShader, frustum);
+
+        // Camera and lights come from the frame uniform blocks
         shader.Bind();
 
-        // Set camera uniforms
-        float aspect = 1280.0f / 720.0f;
-        shader.SetMat4("u_View", camera.GetViewMatrix());
-        shader.SetMat4("u_Projection", camera.GetProjectionMatrix(aspect));
+        if (gpuCulling)
+            mesh.DrawIndirect(&m_stats);
+        else
+            mesh.Draw(m_cullingMode == CullingMode::None ? nullptr : &frustum, &m_stats);
+    }
 
-        if (lights)
-        {
-            lights->ApplyToShader(shader, camera.GetPosition());
-        }
+    void OpenGLRenderer::DrawTerrain(
+        const OpenGLTerrainMesh &mesh,
+        const core::IShader &shader,
+        const core::ICamera &camera)
+    {
+        shader.Bind();
 
-        mesh.Draw();
+        float aspect = 1280.0f / 720.0f;
+        const Frustum frustum(camera.GetProjectionMatrix(aspect) * camera.GetViewMatrix());
+        mesh.Draw(m_cullingMode == CullingMode::None ? nullptr : &frustum, &m_stats);
     }
 
     void OpenGLRenderer::EndFrame()
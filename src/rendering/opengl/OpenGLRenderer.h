@@ -1,31 +1,68 @@
 #pragma once
 #include "rendering/IRenderer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 
 namespace cozy::rendering
 {
+    class OpenGLShader;
+    class LightClusterGrid;
+
     class OpenGLRenderer : public IRenderer
     {
     public:
-        OpenGLRenderer() = default;
-        ~OpenGLRenderer() override = default;
+        OpenGLRenderer();
+        ~OpenGLRenderer() override;
 
         void Initialize(void *nativeWindowHandle) override;
         void BeginFrame() override;
         void EndFrame() override;
         void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 
+        void UpdateFrameUniforms(const core::ICamera &camera, const LightManager *lights = nullptr) override;
+
         void DrawMesh(
             const core::IMesh &mesh,
             const core::IShader &shader,
-            const glm::mat4 &modelMatrix,
-            const core::ICamera &camera) override;
+            const glm::mat4 &modelMatrix) override;
 
         void DrawInstanced(
             const OpenGLInstancedMesh &mesh,
             const core::IShader &shader,
-            const core::ICamera &camera,
-            const LightManager *lights = nullptr) override;
+            const core::ICamera &camera) override;
+
+        void DrawTerrain(
+            const OpenGLTerrainMesh &mesh,
+            const core::IShader &shader,
+            const core::ICamera &camera) override;
 
         void BindTexture(const core::ITexture &texture, uint32_t slot = 0) override;
+
+        void SetCullingMode(CullingMode mode) override { m_cullingMode = mode; }
+        [[nodiscard]] CullingMode GetCullingMode() const noexcept override { return m_cullingMode; }
+
+        [[nodiscard]] const RenderStats &GetFrameStats() const noexcept override { return m_stats; }
+
+    private:
+        RenderStats m_stats;
+        CullingMode m_cullingMode{CullingMode::Cpu};
+        std::unique_ptr<OpenGLShader> m_cullShader; // cull.comp, for CullingMode::Gpu
+
+        // Uniform buffers bound to CAMERA_BLOCK_BINDING / LIGHTS_BLOCK_BINDING
+        uint32_t m_cameraUBO{0};
+        uint32_t m_lightsUBO{0};
+        const LightManager *m_uploadedLights{nullptr};
+        uint64_t m_uploadedLightsVersion{0};
+
+        // Clustered lighting: per-frame light lists in storage buffers bound to
+        // CLUSTER_LIGHTS_BINDING / CLUSTER_RANGES_BINDING / CLUSTER_INDICES_BINDING
+        std::unique_ptr<LightClusterGrid> m_clusters;
+        uint32_t m_clusterLightsSSBO{0};
+        uint32_t m_clusterRangesSSBO{0};
+        uint32_t m_clusterIndicesSSBO{0};
+        size_t m_clusterLightsCapacity{0};
+        size_t m_clusterRangesCapacity{0};
+        size_t m_clusterIndicesCapacity{0};
     };
 }
\ No newline at end of file
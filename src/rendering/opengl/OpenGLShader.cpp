@@ -1,15 +1,9 @@
 #include "rendering/opengl/OpenGLShader.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
-#include "shaders_embedded.h"
 
 namespace cozy::rendering
 {
-    OpenGLShader::OpenGLShader()
-        : OpenGLShader(embedded_instanced_vert, embedded_instanced_frag)
-    {
-    }
-
     OpenGLShader::OpenGLShader(const char *vertexSource, const char *fragmentSource)
     {
         uint32_t vertex = glCreateShader(GL_VERTEX_SHADER);
@@ -32,6 +26,32 @@ namespace cozy::rendering
         glDeleteShader(fragment);
     }
 
+    OpenGLShader::OpenGLShader(const char *computeSource)
+    {
+        uint32_t compute = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(compute, 1, &computeSource, nullptr);
+        glCompileShader(compute);
+        checkCompileErrors(compute, "COMPUTE");
+
+        m_id = glCreateProgram();
+        glAttachShader(m_id, compute);
+        glLinkProgram(m_id);
+        checkLinkErrors(m_id);
+
+        glDeleteShader(compute);
+    }
+
+    std::string OpenGLShader::WithDefines(const char *source, const std::string &defines)
+    {
+        std::string out(source);
+        const size_t version = out.find("#version");
+        const size_t lineEnd = version == std::string::npos ? std::string::npos : out.find('\n', version);
+        if (lineEnd == std::string::npos)
+            return defines + out;
+        out.insert(lineEnd + 1, defines);
+        return out;
+    }
+
     OpenGLShader::~OpenGLShader()
     {
         glDeleteProgram(m_id);
@@ -52,6 +72,11 @@ namespace cozy::rendering
         glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
+    void OpenGLShader::SetMat3(const std::string &name, const glm::mat3 &mat) const
+    {
+        glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
+    }
+
     void OpenGLShader::SetVec3(const std::string &name, const glm::vec3 &val) const
     {
         glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(val));
@@ -62,6 +87,16 @@ namespace cozy::rendering
         glUniform4fv(GetUniformLocation(name), 1, glm::value_ptr(val));
     }
 
+    void OpenGLShader::SetVec4Array(const std::string &name, const glm::vec4 *values, int count) const
+    {
+        glUniform4fv(GetUniformLocation(name), count, glm::value_ptr(*values));
+    }
+
+    void OpenGLShader::SetUint(const std::string &name, uint32_t val) const
+    {
+        glUniform1ui(GetUniformLocation(name), val);
+    }
+
     void OpenGLShader::SetInt(const std::string &name, int val) const
     {
         glUniform1i(GetUniformLocation(name), val);
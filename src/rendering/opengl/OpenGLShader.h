@@ -1,6 +1,7 @@
 #pragma once
 #include "core/graphics/IGpuResource.h"
 #include <glad/glad.h>
+#include <string>
 #include <unordered_map>
 
 namespace cozy::rendering
@@ -8,8 +9,8 @@ namespace cozy::rendering
     class OpenGLShader : public core::IShader
     {
     public:
-        OpenGLShader();
         OpenGLShader(const char *vertexSource, const char *fragmentSource);
+        explicit OpenGLShader(const char *computeSource); // Compute-only program
         ~OpenGLShader() override;
 
         [[nodiscard]] uint32_t GetRendererID() const noexcept override { return m_id; }
@@ -17,10 +18,19 @@ namespace cozy::rendering
         void Bind() const override;
         void Unbind() const override;
         void SetMat4(const std::string &name, const glm::mat4 &mat) const override;
+        void SetMat3(const std::string &name, const glm::mat3 &mat) const override;
         void SetVec3(const std::string &name, const glm::vec3 &val) const override;
         void SetInt(const std::string &name, int val) const override;
         void SetFloat(const std::string &name, float val) const override;
         void SetVec4(const std::string &name, const glm::vec4 &val) const override;
+        void SetUint(const std::string &name, uint32_t val) const;
+        // Uploads `count` elements of a vec4 array uniform in one call
+        void SetVec4Array(const std::string &name, const glm::vec4 *values, int count) const;
+
+        // Copy of `source` with `defines` (one "#define NAME VALUE" per line)
+        // inserted after its #version line, so constants shared with C++ are
+        // supplied at compile time instead of duplicated in the shader
+        static std::string WithDefines(const char *source, const std::string &defines);
 
     private:
         void checkCompileErrors(uint32_t shader, const std::string &type);
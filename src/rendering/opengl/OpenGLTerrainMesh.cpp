@@ -0,0 +1,120 @@
+#include "OpenGLTerrainMesh.h"
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace cozy::rendering
+{
+    OpenGLTerrainMesh::~OpenGLTerrainMesh()
+    {
+        Release();
+    }
+
+    void OpenGLTerrainMesh::Upload(const std::vector<TerrainChunk> &chunks)
+    {
+        if (m_chunks.size() != chunks.size())
+            Create(chunks.size());
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+            UploadChunk(i, chunks[i]);
+    }
+
+    void OpenGLTerrainMesh::UploadChunk(size_t index, const TerrainChunk &chunk)
+    {
+        ChunkBuffers &gpu = m_chunks[index];
+        m_triangleCount -= gpu.indexCount / 3;
+        gpu.indexCount = (uint32_t)chunk.indices.size();
+        gpu.boundsMin = chunk.boundsMin;
+        gpu.boundsMax = chunk.boundsMax;
+        m_triangleCount += chunk.TriangleCount();
+
+        // The element buffer binding is VAO state, so bind the VAO first
+        glBindVertexArray(gpu.vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+        if (chunk.vertices.size() <= gpu.vertexCapacity)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, chunk.vertices.size() * sizeof(TerrainVertex), chunk.vertices.data());
+        }
+        else
+        {
+            gpu.vertexCapacity = chunk.vertices.size();
+            glBufferData(GL_ARRAY_BUFFER, chunk.vertices.size() * sizeof(TerrainVertex), chunk.vertices.data(), GL_DYNAMIC_DRAW);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.ebo);
+        if (chunk.indices.size() <= gpu.indexCapacity)
+        {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, chunk.indices.size() * sizeof(uint16_t), chunk.indices.data());
+        }
+        else
+        {
+            gpu.indexCapacity = chunk.indices.size();
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, chunk.indices.size() * sizeof(uint16_t), chunk.indices.data(), GL_DYNAMIC_DRAW);
+        }
+
+        glBindVertexArray(0);
+    }
+
+    void OpenGLTerrainMesh::Create(size_t count)
+    {
+        Release();
+        m_chunks.resize(count);
+
+        GLsizei stride = (GLsizei)sizeof(TerrainVertex);
+        for (ChunkBuffers &gpu : m_chunks)
+        {
+            glGenVertexArrays(1, &gpu.vao);
+            glGenBuffers(1, &gpu.vbo);
+            glGenBuffers(1, &gpu.ebo);
+
+            glBindVertexArray(gpu.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.ebo);
+
+            glEnableVertexAttribArray(0); // Pos
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(TerrainVertex, position));
+            glEnableVertexAttribArray(1); // Normal
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(TerrainVertex, normal));
+            glEnableVertexAttribArray(2); // Color
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(TerrainVertex, color));
+        }
+
+        glBindVertexArray(0);
+    }
+
+    void OpenGLTerrainMesh::Draw(const Frustum *frustum, RenderStats *stats) const
+    {
+        for (const ChunkBuffers &gpu : m_chunks)
+        {
+            if (gpu.indexCount == 0)
+                continue;
+            if (frustum && !frustum->IntersectsBox(gpu.boundsMin, gpu.boundsMax))
+            {
+                if (stats)
+                    stats->acresCulled++;
+                continue;
+            }
+
+            glBindVertexArray(gpu.vao);
+            glDrawElements(GL_TRIANGLES, (GLsizei)gpu.indexCount, GL_UNSIGNED_SHORT, nullptr);
+            if (stats)
+            {
+                stats->acresVisible++;
+                stats->drawCalls++;
+            }
+        }
+        glBindVertexArray(0);
+    }
+
+    void OpenGLTerrainMesh::Release()
+    {
+        for (const ChunkBuffers &gpu : m_chunks)
+        {
+            glDeleteVertexArrays(1, &gpu.vao);
+            glDeleteBuffers(1, &gpu.vbo);
+            glDeleteBuffers(1, &gpu.ebo);
+        }
+        m_chunks.clear();
+        m_triangleCount = 0;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "rendering/TerrainMeshData.h"
+#include "rendering/Frustum.h"
+#include "rendering/RenderStats.h"
+#include <cstdint>
+#include <vector>
+
+namespace cozy::rendering
+{
+    // GPU copy of the per-acre terrain chunks: one vertex/index buffer pair per
+    // acre, drawn with one indexed call each. Chunks can be re-uploaded
+    // individually when their acre changes.
+    class OpenGLTerrainMesh
+    {
+    public:
+        OpenGLTerrainMesh() = default;
+        ~OpenGLTerrainMesh();
+
+        OpenGLTerrainMesh(const OpenGLTerrainMesh &) = delete;
+        OpenGLTerrainMesh &operator=(const OpenGLTerrainMesh &) = delete;
+
+        // Uploads every chunk, creating the per-chunk buffers on first use
+        void Upload(const std::vector<TerrainChunk> &chunks);
+
+        // Re-uploads one chunk; its buffers are rewritten in place when the new
+        // data fits and only grown otherwise
+        void UploadChunk(size_t index, const TerrainChunk &chunk);
+        // Draws the chunks that intersect `frustum` (all when null)
+        void Draw(const Frustum *frustum = nullptr, RenderStats *stats = nullptr) const;
+
+        [[nodiscard]] size_t GetTriangleCount() const noexcept { return m_triangleCount; }
+
+    private:
+        struct ChunkBuffers
+        {
+            uint32_t vao{0};
+            uint32_t vbo{0};
+            uint32_t ebo{0};
+            uint32_t indexCount{0};
+            size_t vertexCapacity{0}; // In vertices
+            size_t indexCapacity{0};  // In indices
+            glm::vec3 boundsMin{0.0f};
+            glm::vec3 boundsMax{0.0f};
+        };
+
+        void Create(size_t count);
+        void Release();
+
+        std::vector<ChunkBuffers> m_chunks;
+        size_t m_triangleCount = 0;
+    };
+}
@@ -6,40 +6,51 @@
 #include "generation/steps/RiverGenerationStep.h"
 #include "generation/steps/RampGenerationStep.h"
 #include "generation/steps/PondGenerationStep.h"
-#include "presentation/TownPresenter.h"
 
 namespace cozy::world
 {
-    Town::Town() { Reset(); }
+    Town::Town()
+    {
+        for (int ax = 0; ax < WIDTH; ++ax)
+            for (int az = 0; az < HEIGHT; ++az)
+                m_acres[ax][az].tiles.Bind(this, ax * Acre::SIZE, az * Acre::SIZE);
+
+        Reset();
+    }
 
     void Town::Reset()
     {
-        for (auto &column : m_acres)
-            for (auto &acre : column)
-                for (auto &row : acre.tiles)
-                    for (auto &tile : row)
-                    {
-                        tile.type = TileType::GRASS;
-                        tile.elevation = 0;
-                        tile.autotileIndex = 0;
-                    }
+        m_layers.types.fill(TileType::GRASS);
+        m_layers.elevations.fill(0);
+        m_layers.autotileIndices.fill(0);
+        m_staleMaskRows.set();
+        m_dirtyAcres.set();
     }
 
-    void Town::Generate(uint64_t seed, const TownConfig &config)
+    void Town::RebuildStaleMaskRows() const
+    {
+        for (int wz = 0; wz < TILES_Z; ++wz)
+        {
+            if (m_staleMaskRows.test(wz))
+                m_masks.RebuildRow(wz, TypeRow(wz), ElevationRow(wz));
+        }
+        m_staleMaskRows.reset();
+    }
+
+    void Town::Generate(uint64_t seed, const TownConfig &config, ReportLevel report_level)
     {
         Reset();
 
         // The pipeline orchestrates the logic steps
         GenerationPipeline pipeline(*this);
-        pipeline.AddStep(ocean::Execute);
-        pipeline.AddStep(cliffs::Execute);
-        pipeline.AddStep(rivers::Execute);
-        pipeline.AddStep(ramps::Execute);
-        pipeline.AddStep(ponds::Execute);
-
-        pipeline.Execute(seed, config);
+        pipeline.AddStep("ocean", ocean::Execute);
+        pipeline.AddStep("cliffs", cliffs::Execute);
+        pipeline.AddStep("rivers", rivers::Execute);
+        pipeline.AddStep("ramps", ramps::Execute);
+        pipeline.AddStep("ponds", ponds::Execute);
 
-        // Delegated to the presenter
-        TownPresenter::DebugDump(*this);
+        pipeline.Execute(seed, config, report_level);
+        m_lastReport = pipeline.GetReport();
+        SetGenerationInfo(seed, config.Hash());
     }
 }
\ No newline at end of file
@@ -3,7 +3,10 @@
 #include <array>
 #include <vector>
 #include <memory>
+#include <bitset>
 #include "data/Acre.h"
+#include "data/TerrainMasks.h"
+#include "generation/instrumentation/GenerationReport.h"
 
 namespace cozy::world
 {
@@ -24,17 +27,172 @@ namespace cozy::world
         static constexpr int HEIGHT = 7; // Only 6 render on the town map. 7 (or ACRE G) is for pure ocean acres beyond the normal town map
         static constexpr int BEACH_ACRE_ROW = HEIGHT - 2;
 
+        // World-space tile grid dimensions
+        static constexpr int TILES_X = WIDTH * Acre::SIZE;
+        static constexpr int TILES_Z = HEIGHT * Acre::SIZE;
+        static constexpr int TILE_COUNT = TILES_X * TILES_Z;
+        static constexpr int ACRE_COUNT = WIDTH * HEIGHT;
+
         Town();
 
+        // Structure-of-arrays tile storage: each attribute is its own contiguous,
+        // row-major (z, then x) byte plane, so single-attribute passes touch a
+        // third of the memory and vectorize.
+        struct TileLayers
+        {
+            std::array<TileType, TILE_COUNT> types;
+            std::array<int8_t, TILE_COUNT> elevations;
+            std::array<uint8_t, TILE_COUNT> autotileIndices;
+        };
+
+        using TerrainMaskSet = TerrainMasks<TILES_X, TILES_Z>;
+
+        // One bit per acre, indexed by AcreIndex (acre-major: ax outer, az inner)
+        using AcreMask = std::bitset<ACRE_COUNT>;
+        static constexpr int AcreIndex(int ax, int az) { return ax * HEIGHT + az; }
+
+        // Acres hold views back into this Town, so a Town cannot be copied or moved
+        Town(const Town &) = delete;
+        Town &operator=(const Town &) = delete;
+
         // Core Actions
-        void Generate(uint64_t seed, const TownConfig &config);
+        void Generate(uint64_t seed, const TownConfig &config, ReportLevel report_level = ReportLevel::Timing);
         void Reset();
 
         // Data Accessors
         Acre &GetAcre(int ax, int az) { return m_acres[ax][az]; }
         const Acre &GetAcre(int ax, int az) const { return m_acres[ax][az]; }
 
+        // Unchecked world-space access through the Tile facade. Callers must stay
+        // within TILES_X/TILES_Z; use utils::GetTileSafe when the coordinate may
+        // be out of bounds.
+        static constexpr int TileIndex(int wx, int wz) { return wz * TILES_X + wx; }
+        TileRef TileAt(int wx, int wz)
+        {
+            const int i = TileIndex(wx, wz);
+            return {{m_layers.types[i], *this, i}, {m_layers.elevations[i], *this, i}, {m_layers.autotileIndices[i], *this, i}};
+        }
+        Tile TileAt(int wx, int wz) const
+        {
+            const int i = TileIndex(wx, wz);
+            return {m_layers.types[i], m_layers.elevations[i], m_layers.autotileIndices[i]};
+        }
+
+        // Single-plane rows for linear full-map scans. Writing through a mutable
+        // type/elevation row marks that row's terrain masks stale; they are
+        // re-derived on the next Masks() call, so don't hold a mutable row
+        // across a mask query.
+        const TileType *TypeRow(int wz) const { return &m_layers.types[TileIndex(0, wz)]; }
+        const int8_t *ElevationRow(int wz) const { return &m_layers.elevations[TileIndex(0, wz)]; }
+        const uint8_t *AutotileRow(int wz) const { return &m_layers.autotileIndices[TileIndex(0, wz)]; }
+        // Every mutable row also marks the acres it crosses dirty.
+        TileType *MutableTypeRow(int wz)
+        {
+            m_staleMaskRows.set(wz);
+            MarkRowAcresDirty(wz);
+            return &m_layers.types[TileIndex(0, wz)];
+        }
+        int8_t *MutableElevationRow(int wz)
+        {
+            m_staleMaskRows.set(wz);
+            MarkRowAcresDirty(wz);
+            return &m_layers.elevations[TileIndex(0, wz)];
+        }
+        uint8_t *MutableAutotileRow(int wz)
+        {
+            MarkRowAcresDirty(wz);
+            return &m_layers.autotileIndices[TileIndex(0, wz)];
+        }
+
+        const TileLayers &Layers() const { return m_layers; }
+
+        // Per-class bitboards (water, cliff, elevation levels, ...) matching the current tiles
+        const TerrainMaskSet &Masks() const
+        {
+            if (m_staleMaskRows.any())
+                RebuildStaleMaskRows();
+            return m_masks;
+        }
+
+        // Acres whose tiles changed since the last ClearDirtyAcres (all of them
+        // after Reset/Generate). Presentation uses this to refresh only the
+        // affected instance ranges and meshes.
+        const AcreMask &DirtyAcres() const { return m_dirtyAcres; }
+        void ClearDirtyAcres() { m_dirtyAcres.reset(); }
+
+        // Per-step stats from the most recent Generate call, at the level it asked for
+        const GenerationReport &GetLastReport() const { return m_lastReport; }
+
+        // Seed and TownConfig::Hash of the settings that produced the current
+        // tiles; set by Generate, or by whoever restores a stored town
+        uint64_t GetSeed() const { return m_seed; }
+        uint64_t GetConfigHash() const { return m_configHash; }
+        void SetGenerationInfo(uint64_t seed, uint64_t config_hash)
+        {
+            m_seed = seed;
+            m_configHash = config_hash;
+        }
+
     private:
+        template <typename T>
+        friend class TileField;
+
+        template <typename T>
+        void WriteTileField(T &field, T value, int index);
+        void RebuildStaleMaskRows() const;
+        void MarkRowAcresDirty(int wz)
+        {
+            for (int ax = 0; ax < WIDTH; ++ax)
+                m_dirtyAcres.set(AcreIndex(ax, wz / Acre::SIZE));
+        }
+
+        TileLayers m_layers;
         std::array<std::array<Acre, HEIGHT>, WIDTH> m_acres;
+        GenerationReport m_lastReport;
+        uint64_t m_seed = 0;
+        uint64_t m_configHash = 0;
+
+        // Derived from m_layers; rows flagged stale are rebuilt lazily by Masks()
+        mutable TerrainMaskSet m_masks;
+        mutable std::bitset<TILES_Z> m_staleMaskRows;
+
+        AcreMask m_dirtyAcres;
     };
-}
\ No newline at end of file
+
+    template <typename T>
+    inline TileField<T> &TileField<T>::operator=(T value)
+    {
+        if (*m_value != value)
+            m_town->WriteTileField(*m_value, value, m_index);
+        return *this;
+    }
+
+    template <typename T>
+    inline void Town::WriteTileField(T &field, T value, int index)
+    {
+        const int wz = index / TILES_X;
+        const int wx = index - wz * TILES_X;
+        m_dirtyAcres.set(AcreIndex(wx / Acre::SIZE, wz / Acre::SIZE));
+
+        if (m_staleMaskRows.test(wz))
+        {
+            field = value;
+            return;
+        }
+
+        const uint32_t before = TerrainMaskSet::Classify(m_layers.types[index], m_layers.elevations[index]);
+        field = value;
+        const uint32_t after = TerrainMaskSet::Classify(m_layers.types[index], m_layers.elevations[index]);
+        m_masks.UpdateTile(wx, wz, before, after);
+    }
+
+    inline TileRef AcreTiles::Row::operator[](int local_x) const
+    {
+        return m_town->TileAt(m_originX + local_x, m_wz);
+    }
+
+    inline Tile AcreTiles::ConstRow::operator[](int local_x) const
+    {
+        return m_town->TileAt(m_originX + local_x, m_wz);
+    }
+}
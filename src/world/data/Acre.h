@@ -17,16 +17,67 @@ namespace cozy::world
         bool blocks_path = true;
     };
 
+    class Town;
+
+    // Non-owning 16x16 window into the town's world-space tile planes.
+    // tiles[local_z][local_x] indexes exactly like a nested array would and
+    // resolves to Town::TileAt, so writes go through the same facade.
+    // Row accessors are defined in Town.h.
+    class AcreTiles
+    {
+    public:
+        class Row
+        {
+        public:
+            Row(Town *town, int origin_x, int wz) : m_town(town), m_originX(origin_x), m_wz(wz) {}
+
+            TileRef operator[](int local_x) const;
+
+        private:
+            Town *m_town;
+            int m_originX;
+            int m_wz;
+        };
+
+        class ConstRow
+        {
+        public:
+            ConstRow(const Town *town, int origin_x, int wz) : m_town(town), m_originX(origin_x), m_wz(wz) {}
+
+            Tile operator[](int local_x) const;
+
+        private:
+            const Town *m_town;
+            int m_originX;
+            int m_wz;
+        };
+
+        void Bind(Town *town, int origin_x, int origin_z)
+        {
+            m_town = town;
+            m_originX = origin_x;
+            m_originZ = origin_z;
+        }
+
+        Row operator[](int local_z) { return {m_town, m_originX, m_originZ + local_z}; }
+        ConstRow operator[](int local_z) const { return {m_town, m_originX, m_originZ + local_z}; }
+
+    private:
+        Town *m_town = nullptr;
+        int m_originX = 0;
+        int m_originZ = 0;
+    };
+
     class Acre
     {
     public:
         static constexpr int SIZE = 16;
 
-        std::array<std::array<Tile, SIZE>, SIZE> tiles{};
+        AcreTiles tiles; // Bound by the owning Town
         std::vector<ObjectConfig> objects;
         std::unordered_map<uint16_t, const ObjectConfig *> object_lookup;
 
         void RebuildLookup();
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include "Tile.h"
+
+namespace cozy::world
+{
+    // One bit per tile over a W x H grid. Each row is packed into WORDS_PER_ROW
+    // 64-bit words (bit x of a row lives in word x / 64), so neighbour tests
+    // run a whole row segment per instruction.
+    // Bits past W in the last word of a row are always kept clear.
+    template <int W, int H>
+    class Bitboard
+    {
+    public:
+        static constexpr int WIDTH = W;
+        static constexpr int HEIGHT = H;
+        static constexpr int WORDS_PER_ROW = (W + 63) / 64;
+
+        bool Test(int x, int z) const
+        {
+            if (x < 0 || x >= W || z < 0 || z >= H)
+                return false;
+            return (Word(x, z) >> (x & 63)) & 1ULL;
+        }
+
+        void Set(int x, int z, bool value)
+        {
+            const uint64_t bit = 1ULL << (x & 63);
+            uint64_t &word = m_words[z * WORDS_PER_ROW + (x >> 6)];
+            word = value ? (word | bit) : (word & ~bit);
+        }
+
+        void Clear() { m_words.fill(0); }
+
+        uint64_t *Row(int z) { return &m_words[z * WORDS_PER_ROW]; }
+        const uint64_t *Row(int z) const { return &m_words[z * WORDS_PER_ROW]; }
+
+        // Moves every bit by (dx, dz); bits shifted past an edge are dropped.
+        // Shifted(1, 0).Test(x, z) == Test(x - 1, z), i.e. "my west neighbour is set".
+        Bitboard Shifted(int dx, int dz) const
+        {
+            Bitboard out;
+            for (int z = 0; z < H; ++z)
+            {
+                const int src_z = z - dz;
+                if (src_z < 0 || src_z >= H)
+                    continue;
+                ShiftRow(Row(src_z), out.Row(z), dx);
+            }
+            return out;
+        }
+
+        // Tiles with at least one set 4-neighbour (excluding the tile itself)
+        Bitboard Neighbors4() const
+        {
+            return Shifted(1, 0) | Shifted(-1, 0) | Shifted(0, 1) | Shifted(0, -1);
+        }
+
+        Bitboard &operator|=(const Bitboard &other)
+        {
+            for (size_t i = 0; i < m_words.size(); ++i)
+                m_words[i] |= other.m_words[i];
+            return *this;
+        }
+
+        Bitboard &operator&=(const Bitboard &other)
+        {
+            for (size_t i = 0; i < m_words.size(); ++i)
+                m_words[i] &= other.m_words[i];
+            return *this;
+        }
+
+        friend Bitboard operator|(Bitboard a, const Bitboard &b) { return a |= b; }
+        friend Bitboard operator&(Bitboard a, const Bitboard &b) { return a &= b; }
+
+    private:
+        static constexpr uint64_t LAST_WORD_MASK = (W % 64 == 0) ? ~0ULL : ((1ULL << (W % 64)) - 1);
+
+        uint64_t Word(int x, int z) const { return m_words[z * WORDS_PER_ROW + (x >> 6)]; }
+
+        static void ShiftRow(const uint64_t *src, uint64_t *dst, int dx)
+        {
+            if (dx == 0)
+            {
+                std::copy(src, src + WORDS_PER_ROW, dst);
+                return;
+            }
+
+            const int word_shift = (dx > 0 ? dx : -dx) >> 6;
+            const int bit_shift = (dx > 0 ? dx : -dx) & 63;
+            for (int i = 0; i < WORDS_PER_ROW; ++i)
+            {
+                // Gather the (up to) two source words that land in word i
+                const int lo = dx > 0 ? i - word_shift : i + word_shift;
+                const int hi = dx > 0 ? lo - 1 : lo + 1;
+                const uint64_t a = (lo >= 0 && lo < WORDS_PER_ROW) ? src[lo] : 0;
+                const uint64_t b = (hi >= 0 && hi < WORDS_PER_ROW) ? src[hi] : 0;
+
+                if (dx > 0)
+                    dst[i] = (a << bit_shift) | (bit_shift ? (b >> (64 - bit_shift)) : 0);
+                else
+                    dst[i] = (a >> bit_shift) | (bit_shift ? (b << (64 - bit_shift)) : 0);
+            }
+            dst[WORDS_PER_ROW - 1] &= LAST_WORD_MASK;
+        }
+
+        std::array<uint64_t, WORDS_PER_ROW * H> m_words{};
+    };
+
+    enum class TerrainClass : uint8_t
+    {
+        Water, // Any of utils::IsAnyWater
+        Cliff,
+        Sand,
+        Ramp,
+        Elevation0,
+        Elevation1,
+        Elevation2,
+        COUNT
+    };
+
+    // Packed per-class bitsets over the tile grid. The owning Town keeps these
+    // in step with its tile planes: single-tile writes update the bits in place
+    // and bulk row writes are re-derived a row at a time.
+    template <int W, int H>
+    class TerrainMasks
+    {
+    public:
+        using Board = Bitboard<W, H>;
+
+        // Cliff generation produces at most three tiers (0, 1, 2)
+        static constexpr int ELEVATION_LEVELS = 3;
+
+        const Board &Get(TerrainClass c) const { return m_boards[static_cast<int>(c)]; }
+
+        // Tiles at exactly `level`; levels outside the tracked range never occur and read empty
+        const Board &Elevation(int level) const
+        {
+            static const Board empty{};
+            if (level < 0 || level >= ELEVATION_LEVELS)
+                return empty;
+            return m_boards[static_cast<int>(TerrainClass::Elevation0) + level];
+        }
+
+        // Tiles with an in-bounds 4-neighbour at a strictly lower elevation
+        Board LowerNeighborEdges() const
+        {
+            Board edges;
+            Board below = Elevation(0);
+            for (int level = 1; level < ELEVATION_LEVELS; ++level)
+            {
+                edges |= Elevation(level) & below.Neighbors4();
+                below |= Elevation(level);
+            }
+            return edges;
+        }
+
+        // Bit c is set when a tile of this type/elevation belongs to TerrainClass c
+        static uint32_t Classify(TileType type, int8_t elevation)
+        {
+            auto bit = [](TerrainClass c)
+            { return 1u << static_cast<int>(c); };
+
+            uint32_t classes = 0;
+            switch (type)
+            {
+            case TileType::RIVER:
+            case TileType::WATERFALL:
+            case TileType::POND:
+            case TileType::OCEAN:
+            case TileType::RIVER_MOUTH:
+                classes |= bit(TerrainClass::Water);
+                break;
+            case TileType::CLIFF:
+                classes |= bit(TerrainClass::Cliff);
+                break;
+            case TileType::SAND:
+                classes |= bit(TerrainClass::Sand);
+                break;
+            case TileType::RAMP:
+                classes |= bit(TerrainClass::Ramp);
+                break;
+            default:
+                break;
+            }
+
+            if (elevation >= 0 && elevation < ELEVATION_LEVELS)
+                classes |= 1u << (static_cast<int>(TerrainClass::Elevation0) + elevation);
+            return classes;
+        }
+
+        // Single-tile update from its old to its new classification; only the
+        // boards whose membership changed are touched.
+        void UpdateTile(int x, int z, uint32_t old_classes, uint32_t new_classes)
+        {
+            const int word = x >> 6;
+            const uint64_t bit = 1ULL << (x & 63);
+            for (uint32_t changed = old_classes ^ new_classes; changed != 0; changed &= changed - 1)
+            {
+                int c = 0;
+                while (!((changed >> c) & 1u))
+                    ++c;
+                m_boards[c].Row(z)[word] ^= bit;
+            }
+        }
+
+        void RebuildRow(int z, const TileType *types, const int8_t *elevations)
+        {
+            static_assert(static_cast<int>(TerrainClass::COUNT) <= 8, "class set must fit in a byte");
+
+            uint8_t classes[W];
+            for (int x = 0; x < W; ++x)
+                classes[x] = static_cast<uint8_t>(Classify(types[x], elevations[x]));
+
+            // Eight tiles at a time: mask bit c out of each class byte, then the
+            // multiply gathers byte i's bit into bit i of the top byte
+            // (assumes a little-endian host, like every platform we ship on).
+            for (int c = 0; c < static_cast<int>(TerrainClass::COUNT); ++c)
+            {
+                uint64_t *row = m_boards[c].Row(z);
+                std::fill(row, row + Board::WORDS_PER_ROW, 0);
+
+                int x = 0;
+                for (; x + 8 <= W; x += 8)
+                {
+                    uint64_t bytes;
+                    std::memcpy(&bytes, &classes[x], sizeof(bytes));
+                    const uint64_t bits = (((bytes >> c) & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+                    row[x >> 6] |= bits << (x & 63);
+                }
+                for (; x < W; ++x)
+                    row[x >> 6] |= static_cast<uint64_t>((classes[x] >> c) & 1u) << (x & 63);
+            }
+        }
+
+    private:
+        std::array<Board, static_cast<size_t>(TerrainClass::COUNT)> m_boards{};
+    };
+}
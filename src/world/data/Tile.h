@@ -30,4 +30,46 @@ namespace cozy::world
         int8_t elevation = 0;      // 0 = base, 1 = mid, 2 = high
         uint8_t autotileIndex = 0; // 0-255 bitmask
     };
-}
\ No newline at end of file
+
+    class Town;
+
+    // Write-through handle to one attribute of one tile in the Town planes.
+    // Reads convert to the plain value; writes store it and let the Town keep
+    // its derived state (terrain masks) in step. Defined in Town.h.
+    template <typename T>
+    class TileField
+    {
+    public:
+        TileField(T &value, Town &town, int index) : m_value(&value), m_town(&town), m_index(index) {}
+
+        operator T() const { return *m_value; }
+
+        TileField &operator=(T value);
+        TileField &operator=(const TileField &other) { return *this = static_cast<T>(other); }
+
+    private:
+        T *m_value;
+        Town *m_town;
+        int m_index;
+    };
+
+    // Mutable facade over a single tile whose fields live in separate planes
+    // (see Town::TileLayers). tile.type = ... and tile.elevation = ... work
+    // exactly as on a Tile.
+    struct TileRef
+    {
+        TileField<TileType> type;
+        TileField<int8_t> elevation;
+        TileField<uint8_t> autotileIndex;
+
+        operator Tile() const { return {type, elevation, autotileIndex}; }
+
+        TileRef &operator=(const Tile &tile)
+        {
+            type = tile.type;
+            elevation = tile.elevation;
+            autotileIndex = tile.autotileIndex;
+            return *this;
+        }
+    };
+}
@@ -1,10 +1,27 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <cstring>
 
 namespace cozy::world
 {
+    // How the pipeline hands out randomness. Each version reproduces its own
+    // towns for a given seed; new modes are added rather than changing old ones.
+    enum class GenerationMode : uint8_t
+    {
+        // v1: one std::mt19937_64 seeded with the town seed, threaded through
+        // every step in order
+        LegacyV1 = 1,
+        // v2: each step draws from its own substream seeded by
+        // DeriveStepSeed(seed, step name), so steps can be cached, skipped or
+        // re-run independently
+        SubstreamsV2 = 2
+    };
+
     struct TownConfig
     {
+        GenerationMode generationMode = GenerationMode::LegacyV1;
+
         // Cliff parameters
         int cliffVariationAmount = 2; // In tiles, for organic edges
         int cliffSmoothIterations = 1;
@@ -48,5 +65,52 @@ namespace cozy::world
         int grassBlobSizeMin = 6;
         int grassBlobSizeMax = 8;
         float grassBlobCurveMagnitude = 1.0f;
+
+        // FNV-1a over every tunable field, so stored towns can tell which
+        // settings produced them. Add new fields here too.
+        uint64_t Hash() const
+        {
+            uint64_t hash = 0xCBF29CE484222325ULL;
+            auto mix = [&hash](const auto &value)
+            {
+                unsigned char bytes[sizeof(value)];
+                std::memcpy(bytes, &value, sizeof(value));
+                for (unsigned char b : bytes)
+                {
+                    hash ^= b;
+                    hash *= 0x100000001B3ULL;
+                }
+            };
+
+            mix(static_cast<uint8_t>(generationMode));
+            mix(cliffVariationAmount);
+            mix(cliffSmoothIterations);
+            mix(minPlateauRow);
+            mix(maxPlateauRow);
+            mix(minHighPlateauRowOffset);
+            mix(maxHighPlateauRowOffset);
+            mix(highPlateauChance);
+            mix(rampBuffer);
+            mix(rampTopCandidates);
+            mix(riverWidth);
+            mix(riverMeanderChance);
+            mix(riverHorizontalChance);
+            mix(minPondRadius);
+            mix(maxPondRadius);
+            mix(pondNoiseScale);
+            mix(pondNoiseStrength);
+            mix(pondMargin);
+            mix(pondMinNeighbors);
+            mix(beachBaseDepth);
+            mix(beachAmplitudeMin);
+            mix(beachAmplitudeMax);
+            mix(beachFreqMin);
+            mix(beachFreqMax);
+            mix(beachSandToOceanBuffer);
+            mix(grassBlobSizeMin);
+            mix(grassBlobSizeMax);
+            mix(grassBlobCurveMagnitude);
+            return hash;
+        }
     };
 }
\ No newline at end of file
@@ -1,19 +1,88 @@
 #include "GenerationPipeline.h"
 #include "../Town.h"
+#include "StepSeed.h"
+#include "world/data/TownConfig.h"
+#include "instrumentation/AllocationTracker.h"
+#include "instrumentation/LayerHash.h"
+
+#include <chrono>
 
 namespace cozy::world
 {
 
     GenerationPipeline::GenerationPipeline(Town &target) : m_town(target) {}
 
-    void GenerationPipeline::Execute(uint64_t seed, const TownConfig &config)
+    void GenerationPipeline::Execute(uint64_t seed, const TownConfig &config, ReportLevel level)
     {
+        // Legacy mode shares this engine across steps; substream mode reseeds
+        // it per step
         std::mt19937_64 rng(seed);
+        const bool substreams = (config.generationMode == GenerationMode::SubstreamsV2);
+        const bool full = (level >= ReportLevel::Full);
+        if (full && !m_before)
+            m_before = std::make_unique<Town::TileLayers>();
+
+        m_report = GenerationReport{};
+        m_report.seed = seed;
+        m_report.level = level;
+        m_report.allocationTracking = instrumentation::IsAllocationTrackingEnabled();
+        m_report.steps.reserve(m_steps.size());
 
         for (auto &step : m_steps)
         {
-            step(m_town, rng, config);
+            if (full)
+                *m_before = m_town.Layers();
+
+            if (substreams)
+                rng.seed(DeriveStepSeed(seed, step.name));
+
+            auto allocStart = instrumentation::GetThreadAllocationCounters();
+            auto timeStart = std::chrono::steady_clock::now();
+
+            step.run(m_town, rng, config);
+
+            auto timeEnd = std::chrono::steady_clock::now();
+            auto allocEnd = instrumentation::GetThreadAllocationCounters();
+
+            StepStats stats;
+            stats.name = step.name;
+            stats.durationMs = std::chrono::duration<double, std::milli>(timeEnd - timeStart).count();
+            stats.allocations = allocEnd.count - allocStart.count;
+            stats.allocatedBytes = allocEnd.bytes - allocStart.bytes;
+            if (full)
+            {
+                stats.tilesMutated = CountMutatedTiles();
+                stats.layersHash = instrumentation::HashTileLayers(m_town.Layers());
+            }
+            if (level >= ReportLevel::Acres)
+            {
+                const auto digests = instrumentation::HashAcres(m_town.Layers());
+                stats.acreDigests.assign(digests.begin(), digests.end());
+            }
+            if (level >= ReportLevel::Planes)
+            {
+                static_assert(sizeof(Town::TileLayers) == 3 * Town::TILE_COUNT, "tile planes must be packed");
+                const auto *planes = reinterpret_cast<const uint8_t *>(&m_town.Layers());
+                stats.planes.assign(planes, planes + sizeof(Town::TileLayers));
+            }
+            m_report.steps.push_back(std::move(stats));
+        }
+    }
+
+    uint32_t GenerationPipeline::CountMutatedTiles() const
+    {
+        const Town::TileLayers &before = *m_before;
+        const Town::TileLayers &after = m_town.Layers();
+
+        uint32_t mutated = 0;
+        for (int i = 0; i < Town::TILE_COUNT; ++i)
+        {
+            if (before.types[i] != after.types[i] ||
+                before.elevations[i] != after.elevations[i] ||
+                before.autotileIndices[i] != after.autotileIndices[i])
+                mutated++;
         }
+        return mutated;
     }
 
-}
\ No newline at end of file
+}
@@ -3,30 +3,54 @@
 #include <functional>
 #include <memory>
 #include <random>
+#include <string>
+#include "instrumentation/GenerationReport.h"
+#include "world/Town.h"
 
 namespace cozy::world
 {
 
-    class Town;
     struct TownConfig;
 
     class GenerationPipeline
     {
     public:
+        using StepFunction = std::function<void(Town &, std::mt19937_64 &, const TownConfig &)>;
+
         explicit GenerationPipeline(Town &target_town);
 
-        // Add any callable that matches this signature
+        // Add any callable that matches this signature. The name identifies the
+        // step in the GenerationReport and, in GenerationMode::SubstreamsV2,
+        // keys its RNG substream, so renaming a step changes its output.
         template <typename Callable>
-        void AddStep(Callable &&step)
+        void AddStep(std::string name, Callable &&step)
         {
-            m_steps.emplace_back(std::forward<Callable>(step));
+            m_steps.push_back({std::move(name), StepFunction(std::forward<Callable>(step))});
         }
 
-        void Execute(uint64_t seed, const TownConfig &config);
+        void Execute(uint64_t seed, const TownConfig &config, ReportLevel level = ReportLevel::Timing);
+
+        // Timing and allocation stats from the last Execute, plus mutation
+        // counts and layer hashes when it ran at ReportLevel::Full or above
+        const GenerationReport &GetReport() const { return m_report; }
 
     private:
+        struct NamedStep
+        {
+            std::string name;
+            StepFunction run;
+        };
+
+        uint32_t CountMutatedTiles() const;
+
         Town &m_town;
-        std::vector<std::function<void(Town &, std::mt19937_64 &, const TownConfig &)>> m_steps;
+        std::vector<NamedStep> m_steps;
+        GenerationReport m_report;
+
+        // Tile planes as they were before the running step (ReportLevel::Full
+        // and above). Allocated before the first step so the snapshot never
+        // shows up in a step's allocation counts.
+        std::unique_ptr<Town::TileLayers> m_before;
     };
 
-}
\ No newline at end of file
+}
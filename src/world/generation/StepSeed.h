@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace cozy::world
+{
+    // SplitMix64 output function: a stateless, full-avalanche 64-bit mix. Used
+    // as a counter-based generator, i.e. SplitMix64(key + n) is the n-th draw.
+    constexpr uint64_t SplitMix64(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // FNV-1a over the step id, so ids map to stable keys on every platform
+    constexpr uint64_t HashStepId(std::string_view step_id)
+    {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (char c : step_id)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    // Seed of a step's private RNG substream in GenerationMode::SubstreamsV2.
+    // Depends only on (town seed, step id): never on which steps ran before,
+    // how many draws they made, or their order.
+    constexpr uint64_t DeriveStepSeed(uint64_t town_seed, std::string_view step_id)
+    {
+        return SplitMix64(SplitMix64(town_seed) ^ HashStepId(step_id));
+    }
+}
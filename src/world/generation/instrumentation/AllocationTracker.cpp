@@ -0,0 +1,123 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace cozy::world::instrumentation
+{
+    namespace
+    {
+        thread_local AllocationCounters t_counters;
+    }
+
+#ifdef COZY_TRACK_ALLOCATIONS
+    bool IsAllocationTrackingEnabled() { return true; }
+#else
+    bool IsAllocationTrackingEnabled() { return false; }
+#endif
+
+    AllocationCounters GetThreadAllocationCounters() { return t_counters; }
+
+#ifdef COZY_TRACK_ALLOCATIONS
+    namespace detail
+    {
+        inline void *TrackedAlloc(std::size_t size)
+        {
+            t_counters.count++;
+            t_counters.bytes += size;
+            return std::malloc(size ? size : 1);
+        }
+
+        inline void *TrackedAlignedAlloc(std::size_t size, std::align_val_t align)
+        {
+            t_counters.count++;
+            t_counters.bytes += size;
+            const std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _MSC_VER
+            return _aligned_malloc(size ? size : 1, alignment);
+#else
+            // aligned_alloc wants the size rounded up to the alignment
+            return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        }
+
+        inline void AlignedFree(void *p)
+        {
+#ifdef _MSC_VER
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+    }
+#endif
+}
+
+#ifdef COZY_TRACK_ALLOCATIONS
+// Global replacements of every allocating form: plain, array, nothrow and
+// over-aligned (alignas above __STDCPP_DEFAULT_NEW_ALIGNMENT__). Each delete
+// form frees with the matching allocator.
+void *operator new(std::size_t size)
+{
+    if (void *p = cozy::world::instrumentation::detail::TrackedAlloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    if (void *p = cozy::world::instrumentation::detail::TrackedAlloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return cozy::world::instrumentation::detail::TrackedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return cozy::world::instrumentation::detail::TrackedAlloc(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    if (void *p = cozy::world::instrumentation::detail::TrackedAlignedAlloc(size, align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t align)
+{
+    if (void *p = cozy::world::instrumentation::detail::TrackedAlignedAlloc(size, align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return cozy::world::instrumentation::detail::TrackedAlignedAlloc(size, align);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return cozy::world::instrumentation::detail::TrackedAlignedAlloc(size, align);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { cozy::world::instrumentation::detail::AlignedFree(p); }
+#endif
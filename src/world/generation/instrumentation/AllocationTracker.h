@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace cozy::world::instrumentation
+{
+    // Per-thread heap allocation counters fed by the global operator new
+    // replacement in AllocationTracker.cpp (enabled by COZY_TRACK_ALLOCATIONS).
+    struct AllocationCounters
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    // True when the operator new hooks are compiled in
+    bool IsAllocationTrackingEnabled();
+
+    // Running totals for the calling thread; diff two samples to measure a scope
+    AllocationCounters GetThreadAllocationCounters();
+}
@@ -0,0 +1,85 @@
+#include "GenerationReport.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace cozy::world
+{
+    namespace
+    {
+        const char *LevelName(ReportLevel level)
+        {
+            switch (level)
+            {
+            case ReportLevel::Full:
+                return "full";
+            case ReportLevel::Acres:
+                return "acres";
+            case ReportLevel::Planes:
+                return "planes";
+            default:
+                return "timing";
+            }
+        }
+    }
+
+    double GenerationReport::TotalMs() const
+    {
+        double total = 0.0;
+        for (const auto &step : steps)
+            total += step.durationMs;
+        return total;
+    }
+
+    const StepStats *GenerationReport::FindStep(const std::string &name) const
+    {
+        for (const auto &step : steps)
+        {
+            if (step.name == name)
+                return &step;
+        }
+        return nullptr;
+    }
+
+    void GenerationReport::WriteJson(std::ostream &out) const
+    {
+        out << "{\"seed\":" << seed
+            << ",\"level\":\"" << LevelName(level) << '"'
+            << ",\"allocation_tracking\":" << (allocationTracking ? "true" : "false")
+            << ",\"total_ms\":" << TotalMs()
+            << ",\"steps\":[";
+
+        for (size_t i = 0; i < steps.size(); ++i)
+        {
+            const StepStats &step = steps[i];
+            if (i > 0)
+                out << ',';
+            // Step names are code identifiers, so no escaping is needed
+            out << "{\"name\":\"" << step.name << '"'
+                << ",\"duration_ms\":" << step.durationMs
+                << ",\"allocations\":" << step.allocations
+                << ",\"allocated_bytes\":" << step.allocatedBytes;
+            if (level >= ReportLevel::Full)
+            {
+                // Hex string: JSON numbers lose precision past 2^53
+                char hash[17];
+                std::snprintf(hash, sizeof(hash), "%016" PRIx64, step.layersHash);
+                out << ",\"tiles_mutated\":" << step.tilesMutated
+                    << ",\"layers_hash\":\"" << hash << '"';
+            }
+            if (level >= ReportLevel::Acres)
+            {
+                out << ",\"acre_digests\":\"";
+                for (uint8_t digest : step.acreDigests)
+                {
+                    char hex[3];
+                    std::snprintf(hex, sizeof(hex), "%02x", digest);
+                    out << hex;
+                }
+                out << '"';
+            }
+            out << '}';
+        }
+        out << "]}";
+    }
+}
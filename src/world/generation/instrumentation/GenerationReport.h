@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cozy::world
+{
+    // How much GenerationPipeline::Execute measures per step. Timing reads the
+    // clock and the allocation counters around each step. Full also copies the
+    // tile planes before every step and diffs and hashes them after it, which
+    // is a noticeable share of a whole Generate call, so only tools that read
+    // tilesMutated or layersHash ask for it. Acres adds per-acre digests on
+    // top of Full, for cozy_verify's golden tables. Planes also keeps a copy
+    // of the tile planes after every step, so cozy_verify can name the tile a
+    // step changed; it is only meant for a handful of towns.
+    enum class ReportLevel : uint8_t
+    {
+        Timing,
+        Full,
+        Acres,
+        Planes
+    };
+
+    // Measurements for a single named pipeline step
+    struct StepStats
+    {
+        std::string name;
+        double durationMs = 0.0;
+        uint64_t allocations = 0;    // Heap allocations made while the step ran
+        uint64_t allocatedBytes = 0; // Bytes requested by those allocations
+        uint32_t tilesMutated = 0;   // Tiles whose type, elevation or autotile changed (Full only)
+        uint64_t layersHash = 0;     // HashTileLayers of the tile planes after the step (Full only)
+        std::vector<uint8_t> acreDigests; // HashAcres after the step, AcreIndex order (Acres only)
+        std::vector<uint8_t> planes;      // Types, elevations and autotile indices after the step,
+                                          // TILE_COUNT bytes each as in Town::TileLayers (Planes only)
+    };
+
+    // Everything GenerationPipeline::Execute measured for one town
+    struct GenerationReport
+    {
+        uint64_t seed = 0;
+        ReportLevel level = ReportLevel::Timing;
+        bool allocationTracking = false;
+        std::vector<StepStats> steps;
+
+        double TotalMs() const;
+        const StepStats *FindStep(const std::string &name) const;
+
+        // Machine-readable form, one JSON object
+        void WriteJson(std::ostream &out) const;
+    };
+}
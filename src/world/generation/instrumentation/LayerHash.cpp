@@ -0,0 +1,77 @@
+#include "LayerHash.h"
+#include "world/generation/StepSeed.h"
+
+#include <cstring>
+
+namespace cozy::world::instrumentation
+{
+    namespace
+    {
+        constexpr size_t PLANE_BYTES = Town::TILE_COUNT;
+        constexpr int LANES = 4;
+        static_assert(PLANE_BYTES % (LANES * sizeof(uint64_t)) == 0, "planes must split into whole lane groups");
+        static_assert(Acre::SIZE % sizeof(uint64_t) == 0, "acre rows must split into whole words");
+
+        // Four independent multiply chains over little-endian words, so the
+        // pass runs at load speed instead of one multiply latency per word
+        void HashPlane(const void *plane, uint64_t (&lanes)[LANES])
+        {
+            const auto *bytes = static_cast<const uint8_t *>(plane);
+            for (size_t i = 0; i < PLANE_BYTES; i += LANES * sizeof(uint64_t))
+            {
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes + i + lane * sizeof(uint64_t), sizeof(word));
+                    lanes[lane] = (lanes[lane] ^ word) * 0x100000001B3ULL;
+                }
+            }
+        }
+    }
+
+    uint64_t HashTileLayers(const Town::TileLayers &layers)
+    {
+        uint64_t lanes[LANES] = {0xCBF29CE484222325ULL, 0x84222325CBF29CE4ULL, 0x9E3779B97F4A7C15ULL, 0xBF58476D1CE4E5B9ULL};
+        HashPlane(layers.types.data(), lanes);
+        HashPlane(layers.elevations.data(), lanes);
+        HashPlane(layers.autotileIndices.data(), lanes);
+
+        // The multiply only carries low bits upwards; SplitMix64 folds the
+        // lanes with full avalanche so every input bit reaches every output bit
+        uint64_t hash = 0;
+        for (uint64_t lane : lanes)
+            hash = SplitMix64(hash ^ lane);
+        return hash;
+    }
+
+    std::array<uint8_t, Town::ACRE_COUNT> HashAcres(const Town::TileLayers &layers)
+    {
+        const uint8_t *planes[] = {reinterpret_cast<const uint8_t *>(layers.types.data()),
+                                   reinterpret_cast<const uint8_t *>(layers.elevations.data()),
+                                   layers.autotileIndices.data()};
+
+        std::array<uint8_t, Town::ACRE_COUNT> digests{};
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                uint64_t hash = 0xCBF29CE484222325ULL;
+                for (const uint8_t *plane : planes)
+                {
+                    for (int wz = az * Acre::SIZE; wz < (az + 1) * Acre::SIZE; ++wz)
+                    {
+                        const uint8_t *row = plane + Town::TileIndex(ax * Acre::SIZE, wz);
+                        for (size_t i = 0; i < Acre::SIZE; i += sizeof(uint64_t))
+                        {
+                            uint64_t word;
+                            std::memcpy(&word, row + i, sizeof(word));
+                            hash = (hash ^ word) * 0x100000001B3ULL;
+                        }
+                    }
+                }
+                digests[Town::AcreIndex(ax, az)] = static_cast<uint8_t>(SplitMix64(hash) >> 56);
+            }
+        }
+        return digests;
+    }
+}
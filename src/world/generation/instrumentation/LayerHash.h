@@ -0,0 +1,19 @@
+#pragma once
+#include "world/Town.h"
+#include <array>
+#include <cstdint>
+
+namespace cozy::world::instrumentation
+{
+    // 64-bit fingerprint of the tile planes (types, then elevations, then
+    // autotile indices). Golden tables store these, so the definition is part
+    // of the determinism contract: changing it invalidates every recorded
+    // table, which then has to be re-recorded on a known-good tree.
+    uint64_t HashTileLayers(const Town::TileLayers &layers);
+
+    // One byte per acre (AcreIndex order) fingerprinting its tiles in all
+    // three planes, so golden tables can pin a divergence to an acre without
+    // storing whole planes. At a byte each, a changed acre reads as unchanged
+    // once in 256. Part of the determinism contract like HashTileLayers.
+    std::array<uint8_t, Town::ACRE_COUNT> HashAcres(const Town::TileLayers &layers);
+}
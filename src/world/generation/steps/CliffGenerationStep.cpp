@@ -20,6 +20,10 @@ namespace cozy::world::cliffs
         std::uniform_int_distribution<int> seed_dist(0, 100000);
         int seed = seed_dist(rng);
 
+        // The boundary samples noise along a single row (z = 0)
+        std::vector<float> noise_row(total_width);
+        utils::SmoothNoiseRow(0, 0, total_width, TownConfig::CLIFF_NOISE_SCALE, seed, noise_row.data());
+
         for (int x = 0; x < total_width; ++x)
         {
             int curr_acre = x / Acre::SIZE;
@@ -28,7 +32,7 @@ namespace cozy::world::cliffs
 
             int base_z = (local_x <= config.CLIFF_CONNECTION_POINT_OFFSET) ? targets[curr_acre] : targets[next_acre];
 
-            float noise = utils::SmoothNoise(x * TownConfig::CLIFF_NOISE_SCALE, 0, seed);
+            float noise = noise_row[x];
             int variation = static_cast<int>((noise - 0.5f) * 2.0f * config.cliffVariationAmount);
 
             z_values[x] = base_z + variation;
@@ -76,9 +80,10 @@ namespace cozy::world::cliffs
 
     void ApplyElevations(Town &town, const CliffBoundary &mid, const CliffBoundary &high, bool threeTiers)
     {
-        for (int wx = 0; wx < utils::GetWorldWidth(); ++wx)
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
         {
-            for (int wz = 0; wz < utils::GetWorldHeight(); ++wz)
+            std::int8_t *row = town.MutableElevationRow(wz);
+            for (int wx = 0; wx < Town::TILES_X; ++wx)
             {
                 int elevation = 0;
                 if (wz < mid.z_values[wx])
@@ -86,34 +91,34 @@ namespace cozy::world::cliffs
                 if (threeTiers && wz < high.z_values[wx])
                     elevation = 2;
 
-                if (auto *tile = utils::GetTileSafe(town, wx, wz))
-                {
-                    tile->elevation = static_cast<std::int8_t>(elevation);
-                }
+                row[wx] = static_cast<std::int8_t>(elevation);
             }
         }
     }
 
     void TagCliffFaces(Town &town)
     {
-        for (int wx = 0; wx < utils::GetWorldWidth(); ++wx)
+        // Elevations are final before tagging and only types change here, so the
+        // scan can walk rows linearly and peek at the neighbouring rows directly.
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
         {
-            for (int wz = 0; wz < utils::GetWorldHeight(); ++wz)
+            const std::int8_t *row = town.ElevationRow(wz);
+            const std::int8_t *north = (wz > 0) ? town.ElevationRow(wz - 1) : nullptr;
+            const std::int8_t *south = (wz + 1 < Town::TILES_Z) ? town.ElevationRow(wz + 1) : nullptr;
+            TileType *types = town.MutableTypeRow(wz);
+
+            for (int wx = 0; wx < Town::TILES_X; ++wx)
             {
-                auto *tile = utils::GetTileSafe(town, wx, wz);
-                if (!tile || tile->elevation <= 0)
+                const std::int8_t elev = row[wx];
+                if (elev <= 0)
                     continue;
 
-                for (auto &neighborPos : utils::GetNeighbors4(wx, wz))
+                if ((wx + 1 < Town::TILES_X && row[wx + 1] < elev) ||
+                    (wx > 0 && row[wx - 1] < elev) ||
+                    (south && south[wx] < elev) ||
+                    (north && north[wx] < elev))
                 {
-                    if (auto *nt = utils::GetTileSafe(town, neighborPos.x, neighborPos.y))
-                    {
-                        if (nt->elevation < tile->elevation)
-                        {
-                            tile->type = TileType::CLIFF;
-                            break;
-                        }
-                    }
+                    types[wx] = TileType::CLIFF;
                 }
             }
         }
@@ -56,7 +56,7 @@ namespace cozy::world::ocean
                     int sand_start = sand_boundary[world_x];
                     int ocean_start = sand_start + config.beachSandToOceanBuffer;
 
-                    Tile &tile = acre.tiles[local_z][local_x];
+                    TileRef tile = acre.tiles[local_z][local_x];
 
                     if (local_z >= ocean_start)
                     {
@@ -5,8 +5,9 @@
 #include "world/data/TownConfig.h"
 #include "world/generation/utils/WorldGenUtils.h"
 #include "world/generation/utils/AutoTileUtils.h"
+#include "world/generation/utils/TileSet.h"
+#include "world/generation/utils/IntegralImage.h"
 
-#include <unordered_set>
 #include <algorithm>
 
 namespace cozy::world::ponds
@@ -15,6 +16,13 @@ namespace cozy::world::ponds
     {
         float nX = utils::SmoothNoise(wx * config.pondNoiseScale, wz * config.pondNoiseScale, seed) * config.pondNoiseStrength;
         float nZ = utils::SmoothNoise(wx * config.pondNoiseScale, wz * config.pondNoiseScale, seed + 7919) * config.pondNoiseStrength;
+        return IsPointInside(wx, wz, nX, nZ);
+    }
+
+    bool PondBlob::IsPointInside(int wx, int wz, float noise_x, float noise_z) const
+    {
+        float nX = noise_x;
+        float nZ = noise_z;
 
         float dx = (static_cast<float>(wx) + nX - center.x) / radius_x;
         float dz = (static_cast<float>(wz) + nZ - center.y) / radius_z;
@@ -22,7 +30,8 @@ namespace cozy::world::ponds
         return (dx * dx + dz * dz <= 1.0f);
     }
 
-    bool IsAreaClearForPond(Town &town, glm::ivec2 center, int max_radius, const TownConfig &config)
+    bool IsAreaClearForPond(const Town &town, const utils::IntegralImage &blockers, glm::ivec2 center, int max_radius,
+                            const TownConfig &config)
     {
         const int world_w = utils::GetWorldWidth();
         // Ponds should stay above the beach/ocean row (Row F)
@@ -53,22 +62,8 @@ namespace cozy::world::ponds
         // We scan slightly wider (using pondMargin) to ensure we don't
         // touch cliffs, ramps, or existing river water.
         int check_r = max_radius + config.pondMargin;
-        for (int z = center.y - check_r; z <= center.y + check_r; ++z)
-        {
-            for (int x = center.x - check_r; x <= center.x + check_r; ++x)
-            {
-                TileType type = utils::GetTileTypeSafe(town, x, z);
-
-                // Ponds should only spawn on grass and avoid existing features
-                if (utils::IsAnyWater(type) ||
-                    type == TileType::CLIFF ||
-                    type == TileType::SAND ||
-                    type == TileType::RAMP)
-                {
-                    return false;
-                }
-            }
-        }
+        if (blockers.Any(center.x - check_r, center.y - check_r, center.x + check_r, center.y + check_r))
+            return false;
 
         return true;
     }
@@ -81,6 +76,16 @@ namespace cozy::world::ponds
         bool placed = false;
         PondBlob pond;
 
+        // Tiles a pond may not touch. Nothing changes during the search, so one
+        // table answers every candidate's clearance check.
+        utils::IntegralImage blockers;
+        {
+            const auto &masks = town.Masks();
+            const auto blocked = masks.Get(TerrainClass::Water) | masks.Get(TerrainClass::Cliff) |
+                                 masks.Get(TerrainClass::Sand) | masks.Get(TerrainClass::Ramp);
+            blockers.BuildFromMasks({&blocked});
+        }
+
         // 1. HIGH-LEVEL RETRY LOOP
         // If we can't find a spot for the current pond size, we try again
         // with a potentially different size/shape up to 5 times.
@@ -124,9 +129,9 @@ namespace cozy::world::ponds
                         pond.center.y < search_padding || pond.center.y >= ocean_limit_z - search_padding)
                         continue;
 
-                    if (auto *t = utils::GetTileSafe(town, pond.center.x, pond.center.y))
+                    if (auto t = utils::GetTileSafe(town, pond.center.x, pond.center.y))
                     {
-                        if (t->type == TileType::GRASS && IsAreaClearForPond(town, pond.center, max_reach, config))
+                        if (t->type == TileType::GRASS && IsAreaClearForPond(town, blockers, pond.center, max_reach, config))
                         {
                             pond.target_elevation = t->elevation;
                             placed = true;
@@ -147,24 +152,34 @@ namespace cozy::world::ponds
 
         // 3. Paint Pass
         int max_reach = static_cast<int>(std::ceil(std::max(pond.radius_x, pond.radius_z)));
-        std::unordered_set<glm::ivec2, utils::PairHash> painted;
+        utils::TileSet painted;
         int scan_r = max_reach + config.pondMargin;
 
+        // Edge wobble for a whole row comes from the batched noise kernel
+        const int scan_min_x = pond.center.x - scan_r;
+        const int scan_w = 2 * scan_r + 1;
+        std::vector<float> noise_x(scan_w);
+        std::vector<float> noise_z(scan_w);
+
         for (int wz = pond.center.y - scan_r; wz <= pond.center.y + scan_r; ++wz)
         {
-            for (int wx = pond.center.x - scan_r; wx <= pond.center.x + scan_r; ++wx)
-            {
-                if (wz >= ocean_limit_z)
-                    continue;
+            if (wz >= ocean_limit_z)
+                continue;
+
+            utils::SmoothNoiseRow(scan_min_x, wz, scan_w, config.pondNoiseScale, pond.seed, noise_x.data());
+            utils::SmoothNoiseRow(scan_min_x, wz, scan_w, config.pondNoiseScale, pond.seed + 7919, noise_z.data());
 
-                if (pond.IsPointInside(wx, wz, config))
+            for (int i = 0; i < scan_w; ++i)
+            {
+                const int wx = scan_min_x + i;
+                if (pond.IsPointInside(wx, wz, noise_x[i] * config.pondNoiseStrength, noise_z[i] * config.pondNoiseStrength))
                 {
-                    if (auto *tile = utils::GetTileSafe(town, wx, wz))
+                    if (auto tile = utils::GetTileSafe(town, wx, wz))
                     {
                         if (tile->type == TileType::GRASS && tile->elevation == pond.target_elevation)
                         {
                             tile->type = TileType::POND;
-                            painted.insert({wx, wz});
+                            painted.Insert({wx, wz});
                         }
                     }
                 }
@@ -175,26 +190,22 @@ namespace cozy::world::ponds
         std::vector<glm::ivec2> to_revert;
         for (const auto &pos : painted)
         {
-            int count = 0;
-            for (auto &n : utils::GetNeighbors8(pos.x, pos.y))
-            {
-                if (utils::IsAnyWater(utils::GetTileTypeSafe(town, n.x, n.y)))
-                    count++;
-            }
+            const int count = utils::CountNeighbors8(pos.x, pos.y, [&](int nx, int nz)
+                                                     { return utils::IsAnyWater(town.TypeRow(nz)[nx]); });
             if (count < config.pondMinNeighbors)
                 to_revert.push_back(pos);
         }
 
         for (auto &p : to_revert)
         {
-            if (auto *t = utils::GetTileSafe(town, p.x, p.y))
+            if (auto t = utils::GetTileSafe(town, p.x, p.y))
                 t->type = TileType::GRASS;
-            painted.erase(p);
+            painted.Erase(p);
         }
 
         for (const auto &pos : painted)
         {
-            if (auto *t = utils::GetTileSafe(town, pos.x, pos.y))
+            if (auto t = utils::GetTileSafe(town, pos.x, pos.y))
             {
                 t->autotileIndex = static_cast<uint8_t>(utils::CalculatePondBlobIndex(town, pos.x, pos.y));
             }
@@ -9,6 +9,11 @@ namespace cozy::world
     class Town;
     struct TownConfig;
 
+    namespace utils
+    {
+        class IntegralImage;
+    }
+
     namespace ponds
     {
         struct PondBlob
@@ -20,9 +25,13 @@ namespace cozy::world
             int seed;
 
             bool IsPointInside(int wx, int wz, const TownConfig &config) const;
+            // Same test with the edge noise already sampled and scaled by pondNoiseStrength
+            bool IsPointInside(int wx, int wz, float noise_x, float noise_z) const;
         };
 
-        bool IsAreaClearForPond(Town &town, glm::ivec2 center, int max_radius, const TownConfig &config);
+        // blockers counts the tiles a pond must keep clear of (water, cliff, sand, ramp)
+        bool IsAreaClearForPond(const Town &town, const utils::IntegralImage &blockers, glm::ivec2 center,
+                                int max_radius, const TownConfig &config);
 
         void Execute(Town &town, std::mt19937_64 &rng, const TownConfig &config);
     }
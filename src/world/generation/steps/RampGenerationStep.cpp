@@ -5,6 +5,7 @@
 #include "world/data/Tile.h"
 #include "world/data/TownConfig.h"
 #include "world/generation/utils/WorldGenUtils.h"
+#include "world/generation/utils/IntegralImage.h"
 
 #include <vector>
 #include <algorithm>
@@ -29,6 +30,54 @@ namespace cozy::world
                 float score;        // Quality score for this ramp location
             };
 
+            // Channels of the per-pass region-count table. It is built once per
+            // from/to pass (carving changes elevations between passes) so every
+            // candidate is scored in constant time regardless of corridor and
+            // buffer size.
+            enum RampQueryChannel : int
+            {
+                WATER = 0,
+                WATER_OR_SAND = 1,
+                NOT_FROM_ELEVATION = 2,
+                NOT_TO_ELEVATION = 3
+            };
+
+            void BuildRampQueryTable(utils::IntegralImage &table, const Town &town, int from_elev, int to_elev)
+            {
+                // The channels depend only on (type, elevation), so classify each
+                // combination once; elevations outside 0-2 share the last slot.
+                constexpr int TYPE_COUNT = static_cast<int>(TileType::RAMP) + 1;
+                constexpr int ELEVATION_SLOTS = 4;
+                uint8_t channel_bits[TYPE_COUNT * ELEVATION_SLOTS];
+                for (int t = 0; t < TYPE_COUNT; ++t)
+                {
+                    for (int e = 0; e < ELEVATION_SLOTS; ++e)
+                    {
+                        const TileType type = static_cast<TileType>(t);
+                        const bool water = utils::IsAnyWater(type);
+                        const bool other_elev = (e == ELEVATION_SLOTS - 1);
+
+                        uint8_t bits = 0;
+                        if (water)
+                            bits |= 1u << WATER;
+                        if (water || type == TileType::SAND)
+                            bits |= 1u << WATER_OR_SAND;
+                        if (other_elev || e != from_elev)
+                            bits |= 1u << NOT_FROM_ELEVATION;
+                        if (other_elev || e != to_elev)
+                            bits |= 1u << NOT_TO_ELEVATION;
+                        channel_bits[t * ELEVATION_SLOTS + e] = bits;
+                    }
+                }
+
+                table.Build([&](int x, int z)
+                            {
+                                const int type = static_cast<int>(town.TypeRow(z)[x]);
+                                const int elev = town.ElevationRow(z)[x];
+                                const int slot = (elev >= 0 && elev < ELEVATION_SLOTS - 1) ? elev : ELEVATION_SLOTS - 1;
+                                return channel_bits[type * ELEVATION_SLOTS + slot]; });
+            }
+
             // Helper: Find the approximate X center of the river at a specific Z depth
             // This ensures we determine "West" vs "East" based on the actual river flow.
             int GetRiverCenterX(const Town &town, int z)
@@ -41,13 +90,11 @@ namespace cozy::world
                 // We expand the search slightly in case the cliff is right on a bend
                 for (int dz = -2; dz <= 2; ++dz)
                 {
-                    int scan_z = std::clamp(z + dz, 0, (Town::HEIGHT * Acre::SIZE) - 1);
+                    int scan_z = std::clamp(z + dz, 0, Town::TILES_Z - 1);
+                    const TileType *row = town.TypeRow(scan_z);
                     for (int x = 0; x < w; ++x)
                     {
-                        auto [a, l] = utils::GetTileCoords(x, scan_z);
-                        const Tile &t = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
-
-                        if (t.type == TileType::RIVER || t.type == TileType::WATERFALL)
+                        if (row[x] == TileType::RIVER || row[x] == TileType::WATERFALL)
                         {
                             total_x += x;
                             count++;
@@ -69,10 +116,12 @@ namespace cozy::world
 
                 for (int z = 0; z < h - 1; ++z)
                 {
+                    const int8_t *row = town.ElevationRow(z);
+                    const int8_t *next_row = town.ElevationRow(z + 1);
                     for (int x = 0; x < w; ++x)
                     {
-                        int curr_elev = utils::GetElevation(town, x, z);
-                        int next_elev = utils::GetElevation(town, x, z + 1);
+                        int curr_elev = row[x];
+                        int next_elev = next_row[x];
 
                         // Look for transition from higher to lower going south (increasing z)
                         if (curr_elev == from_elev && next_elev == to_elev)
@@ -87,6 +136,7 @@ namespace cozy::world
             // Score a potential ramp location based on surrounding terrain
             float ScoreRampLocation(
                 const Town &town,
+                const utils::IntegralImage &table,
                 int x,
                 int z_cliff,
                 int from_elev,
@@ -123,69 +173,31 @@ namespace cozy::world
                     }
                 }
 
-                // Check the ramp corridor for obstacles
-                for (int dx = -TownConfig::RAMP_CORRIDOR_HALF_WIDTH; dx <= TownConfig::RAMP_CORRIDOR_HALF_WIDTH; ++dx)
-                {
-                    int rx = x + dx;
-                    if (rx < 0 || rx >= w)
-                    {
-                        score -= 20.0f;
-                        continue;
-                    }
-
-                    for (int rz = z_start; rz <= z_end; ++rz)
-                    {
-                        if (rz < 0 || rz >= h)
-                            continue;
+                const int corridor_min_x = x - TownConfig::RAMP_CORRIDOR_HALF_WIDTH;
+                const int corridor_max_x = x + TownConfig::RAMP_CORRIDOR_HALF_WIDTH;
 
-                        int elev = utils::GetElevation(town, rx, rz);
-
-                        if (rz < z_cliff && elev != from_elev)
-                            score -= 15.0f;
-                        else if (rz > z_cliff && elev != to_elev)
-                            score -= 15.0f;
+                // Check the ramp corridor for obstacles: any water or sand rules it out
+                if (table.Any(corridor_min_x, z_start, corridor_max_x, z_end, WATER_OR_SAND))
+                    return 0.0f;
 
-                        auto [a, l] = utils::GetTileCoords(rx, rz);
-                        const Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                // Corridor columns hanging off the map
+                const int min_x = std::max(corridor_min_x, 0);
+                const int max_x = std::min(corridor_max_x, w - 1);
+                score -= 20.0f * static_cast<float>((min_x - corridor_min_x) + (corridor_max_x - max_x));
 
-                        if (tile.type == TileType::RIVER ||
-                            tile.type == TileType::WATERFALL ||
-                            tile.type == TileType::RIVER_MOUTH ||
-                            tile.type == TileType::OCEAN ||
-                            tile.type == TileType::SAND ||
-                            tile.type == TileType::POND)
-                        {
-                            return 0.0f;
-                        }
-                    }
-                }
+                // Every tile above the edge that isn't at from_elev, or below it and
+                // not at to_elev, costs 15 points
+                const int mismatches =
+                    table.Count(min_x, z_start, max_x, z_cliff - 1, NOT_FROM_ELEVATION) +
+                    table.Count(min_x, z_cliff + 1, max_x, z_end, NOT_TO_ELEVATION);
+                score -= 15.0f * static_cast<float>(mismatches);
 
                 // RULE: Water Clearance
-                for (int dx = -TownConfig::RAMP_CORRIDOR_HALF_WIDTH - config.rampBuffer;
-                     dx <= TownConfig::RAMP_CORRIDOR_HALF_WIDTH + config.rampBuffer; ++dx)
+                const int clearance = TownConfig::RAMP_CORRIDOR_HALF_WIDTH + config.rampBuffer;
+                if (table.Any(x - clearance, z_start - config.rampBuffer,
+                              x + clearance, z_end + config.rampBuffer, WATER))
                 {
-                    int rx = x + dx;
-                    if (rx < 0 || rx >= w)
-                        continue;
-
-                    for (int rz = z_start - config.rampBuffer; rz <= z_end + config.rampBuffer; ++rz)
-                    {
-                        if (rz < 0 || rz >= h)
-                            continue;
-
-                        auto [a, l] = utils::GetTileCoords(rx, rz);
-                        const Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
-
-                        // Check against all water types defined in your legend
-                        if (tile.type == TileType::RIVER ||
-                            tile.type == TileType::WATERFALL ||
-                            tile.type == TileType::RIVER_MOUTH ||
-                            tile.type == TileType::OCEAN ||
-                            tile.type == TileType::POND)
-                        {
-                            return 0.0f;
-                        }
-                    }
+                    return 0.0f;
                 }
 
                 return std::max(0.0f, score);
@@ -203,9 +215,12 @@ namespace cozy::world
                 if (cliff_edges.empty())
                     return candidates;
 
+                utils::IntegralImage table;
+                BuildRampQueryTable(table, town, from_elev, to_elev);
+
                 for (const auto &edge : cliff_edges)
                 {
-                    float score = ScoreRampLocation(town, edge.x, edge.y, from_elev, to_elev, config);
+                    float score = ScoreRampLocation(town, table, edge.x, edge.y, from_elev, to_elev, config);
 
                     if (score > 0.0f)
                     {
@@ -288,8 +303,7 @@ namespace cozy::world
                             int x = ramp.x + dx;
                             if (x < 0 || x >= w)
                                 continue;
-                            auto [a, l] = utils::GetTileCoords(x, z);
-                            Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                            TileRef tile = town.TileAt(x, z);
                             if (tile.type != TileType::RIVER && tile.type != TileType::WATERFALL &&
                                 tile.type != TileType::OCEAN && tile.type != TileType::SAND)
                             {
@@ -331,8 +345,7 @@ namespace cozy::world
                         if (x < 0 || x >= w)
                             continue;
 
-                        auto [a, l] = utils::GetTileCoords(x, z);
-                        Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                        TileRef tile = town.TileAt(x, z);
 
                         if (tile.type == TileType::RIVER || tile.type == TileType::WATERFALL ||
                             tile.type == TileType::RIVER_MOUTH || tile.type == TileType::OCEAN ||
@@ -354,19 +367,13 @@ namespace cozy::world
             const TownConfig &config)
         {
             std::vector<int> elevations;
-            const int w = Town::WIDTH * Acre::SIZE;
-            const int h = Town::HEIGHT * Acre::SIZE;
 
             // 1. Identify all unique elevations present in the town
-            for (int z = 0; z < h; ++z)
+            for (int elev : town.Layers().elevations)
             {
-                for (int x = 0; x < w; ++x)
+                if (elev > 0 && std::find(elevations.begin(), elevations.end(), elev) == elevations.end())
                 {
-                    int elev = utils::GetElevation(town, x, z);
-                    if (elev > 0 && std::find(elevations.begin(), elevations.end(), elev) == elevations.end())
-                    {
-                        elevations.push_back(elev);
-                    }
+                    elevations.push_back(elev);
                 }
             }
             // Sort high to low to process cliff levels sequentially
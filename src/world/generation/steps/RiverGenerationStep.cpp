@@ -6,12 +6,12 @@
 #include "world/data/TownConfig.h"
 #include "world/generation/utils/WorldGenUtils.h"
 #include "world/generation/utils/AutoTileUtils.h"
+#include "world/generation/utils/TileSet.h"
 
 #include <vector>
 #include <algorithm>
 #include <random>
 #include <cmath>
-#include <unordered_set>
 #include <glm/glm.hpp>
 
 namespace cozy::world
@@ -77,7 +77,8 @@ namespace cozy::world
 
         // Fill gaps between consecutive river positions
         void FillGaps(Town &town, int from_x, int to_x, int z, int half_width,
-                      std::unordered_set<glm::ivec2, utils::PairHash> &tracker)
+                      const CliffDropMask &cliff_drops,
+                      utils::TileSet &tracker)
         {
             if (from_x == to_x)
                 return;
@@ -85,7 +86,7 @@ namespace cozy::world
             int dir = (to_x > from_x) ? 1 : -1;
             for (int x = from_x; x != to_x; x += dir)
             {
-                CarveRiverSection(town, x, z, half_width, tracker);
+                CarveRiverSection(town, x, z, half_width, cliff_drops, tracker);
             }
         }
 
@@ -149,7 +150,8 @@ namespace cozy::world
             int center_x,
             int center_z,
             int half_width,
-            std::unordered_set<glm::ivec2, utils::PairHash> &painted_tracker) // Added tracker
+            const CliffDropMask &cliff_drops,
+            utils::TileSet &painted_tracker)
         {
             const int w = Town::WIDTH * Acre::SIZE;
             const int h = Town::HEIGHT * Acre::SIZE;
@@ -163,28 +165,12 @@ namespace cozy::world
 
                     if (wx >= 0 && wx < w && wz >= 0 && wz < h)
                     {
-                        auto [a, l] = utils::GetTileCoords(wx, wz);
-                        Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                        TileRef tile = town.TileAt(wx, wz);
 
                         if (tile.type == TileType::OCEAN)
                             continue;
 
-                        bool is_cliff_drop = false;
-                        const int neighbor_offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-                        for (auto &off : neighbor_offsets)
-                        {
-                            int nx = wx + off[0];
-                            int nz = wz + off[1];
-                            if (nx >= 0 && nx < w && nz >= 0 && nz < h)
-                            {
-                                int neighbor_elev = utils::GetElevation(town, nx, nz);
-                                if (tile.elevation > neighbor_elev && neighbor_elev != -1)
-                                {
-                                    is_cliff_drop = true;
-                                    break;
-                                }
-                            }
-                        }
+                        const bool is_cliff_drop = cliff_drops.Test(wx, wz);
 
                         if (is_cliff_drop || tile.type == TileType::CLIFF)
                             tile.type = TileType::WATERFALL;
@@ -194,7 +180,7 @@ namespace cozy::world
                             tile.type = TileType::RIVER;
 
                         // Track this tile for the auto-tiling pass
-                        painted_tracker.insert({wx, wz});
+                        painted_tracker.Insert({wx, wz});
                     }
                 }
             }
@@ -213,31 +199,15 @@ namespace cozy::world
             {
                 for (int x = 0; x < total_w; ++x)
                 {
-                    auto [a, l] = utils::GetTileCoords(x, z);
-                    Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                    TileRef tile = town.TileAt(x, z);
 
                     if (tile.type != TileType::RIVER)
                         continue;
 
-                    bool touches_ocean_or_sand = false;
-                    const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-
-                    for (auto &off : offsets)
-                    {
-                        int nx = x + off[0];
-                        int nz = z + off[1];
-                        if (nx < 0 || nx >= total_w || nz < 0 || nz >= total_h)
-                            continue;
-
-                        auto [na, nl] = utils::GetTileCoords(nx, nz);
-                        const Tile &nTile = town.GetAcre(na.x, na.y).tiles[nl.y][nl.x];
-
-                        if (nTile.type == TileType::OCEAN || nTile.type == TileType::SAND)
-                        {
-                            touches_ocean_or_sand = true;
-                            break;
-                        }
-                    }
+                    const bool touches_ocean_or_sand = utils::AnyNeighbor4(x, z, [&](int nx, int nz)
+                                                                           {
+                                                                               const TileType n_type = town.TypeRow(nz)[nx];
+                                                                               return n_type == TileType::OCEAN || n_type == TileType::SAND; });
 
                     if (touches_ocean_or_sand)
                     {
@@ -260,8 +230,7 @@ namespace cozy::world
                 {
                     for (int x = 0; x < total_w; ++x)
                     {
-                        auto [a, l] = utils::GetTileCoords(x, z);
-                        Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                        TileRef tile = town.TileAt(x, z);
 
                         // Remove Sand touching the River/Mouth — expanded to ~3 tiles radius
                         if (tile.type == TileType::RIVER || tile.type == TileType::RIVER_MOUTH)
@@ -282,8 +251,7 @@ namespace cozy::world
                                     if (nx < 0 || nx >= total_w || nz < 0 || nz >= total_h)
                                         continue;
 
-                                    auto [na, nl] = utils::GetTileCoords(nx, nz);
-                                    Tile &nTile = town.GetAcre(na.x, na.y).tiles[nl.y][nl.x];
+                                    TileRef nTile = town.TileAt(nx, nz);
 
                                     if (nTile.type == TileType::SAND)
                                     {
@@ -297,22 +265,10 @@ namespace cozy::world
                         // Remove isolated Sand trapped by Grass
                         if (tile.type == TileType::SAND)
                         {
-                            int grass_adj = 0;
-                            const int n_off[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-                            for (auto &off : n_off)
-                            {
-                                int nx = x + off[0], nz = z + off[1];
-                                if (nx < 0 || nx >= total_w || nz < 0 || nz >= total_h)
-                                {
-                                    grass_adj++; // Count map edge as grass for cleanup
-                                    continue;
-                                }
-                                auto [na, nl] = utils::GetTileCoords(nx, nz);
-                                if (town.GetAcre(na.x, na.y).tiles[nl.y][nl.x].type == TileType::GRASS)
-                                {
-                                    grass_adj++;
-                                }
-                            }
+                            // Count map edge as grass for cleanup
+                            const int grass_adj = utils::CountNeighbors4(x, z, [&](int nx, int nz)
+                                                                         { return town.TypeRow(nz)[nx] == TileType::GRASS; },
+                                                                         true);
 
                             if (grass_adj == 4)
                             {
@@ -336,7 +292,7 @@ namespace cozy::world
             std::uniform_int_distribution<int> horizontal_length(0, 2);
 
             // Tracker for all tiles changed to water to perform autotiling at the end
-            std::unordered_set<glm::ivec2, utils::PairHash> river_tiles;
+            utils::TileSet river_tiles(2048);
 
             // 1. Generate target column for each acre row
             std::vector<int> column_targets(Town::HEIGHT);
@@ -453,6 +409,10 @@ namespace cozy::world
             }
 
             // 3. Carve the river and track painted tiles
+            // Carving only retypes tiles, so the cliff-drop edges (tiles with a lower
+            // 4-neighbour) are fixed for the whole pass and can be computed once.
+            const CliffDropMask cliff_drops = town.Masks().LowerNeighborEdges();
+
             for (size_t i = 0; i < river_path.size(); ++i)
             {
                 auto [x, z] = river_path[i];
@@ -466,14 +426,14 @@ namespace cozy::world
                     {
                         int dir = (x > prev_x) ? 1 : -1;
                         for (int fill_x = prev_x; fill_x != x; fill_x += dir)
-                            CarveRiverSection(town, fill_x, z, halfWidth, river_tiles);
+                            CarveRiverSection(town, fill_x, z, halfWidth, cliff_drops, river_tiles);
                     }
                     // Fill Z gaps
                     else if (prev_z != z && prev_x == x)
                     {
                         int dir = (z > prev_z) ? 1 : -1;
                         for (int fill_z = prev_z; fill_z != z; fill_z += dir)
-                            CarveRiverSection(town, x, fill_z, halfWidth, river_tiles);
+                            CarveRiverSection(town, x, fill_z, halfWidth, cliff_drops, river_tiles);
                     }
                     // Fill diagonal gaps (Bresenham)
                     else if (prev_x != x && prev_z != z)
@@ -484,7 +444,7 @@ namespace cozy::world
                         int curr_x = prev_x, curr_z = prev_z;
                         while (curr_x != x || curr_z != z)
                         {
-                            CarveRiverSection(town, curr_x, curr_z, halfWidth, river_tiles);
+                            CarveRiverSection(town, curr_x, curr_z, halfWidth, cliff_drops, river_tiles);
                             int e2 = 2 * err;
                             if (e2 > -dz)
                             {
@@ -499,7 +459,7 @@ namespace cozy::world
                         }
                     }
                 }
-                CarveRiverSection(town, x, z, halfWidth, river_tiles);
+                CarveRiverSection(town, x, z, halfWidth, cliff_drops, river_tiles);
             }
 
             // 4. Create River Mouths (updates river_tiles types to RIVER_MOUTH and handles sand/grass cleanup)
@@ -509,8 +469,7 @@ namespace cozy::world
             // We iterate over the tracked tiles to set the correct bitmask indices
             for (const auto &pos : river_tiles)
             {
-                auto [a, l] = utils::GetTileCoords(pos.x, pos.y);
-                Tile &tile = town.GetAcre(a.x, a.y).tiles[l.y][l.x];
+                TileRef tile = town.TileAt(pos.x, pos.y);
 
                 // Only autotile water types (River, Mouth, etc.)
                 if (utils::IsAnyWater(tile.type))
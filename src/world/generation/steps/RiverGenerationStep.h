@@ -2,21 +2,25 @@
 #include "world/Town.h"
 #include "world/data/TownConfig.h"
 #include "world/generation/utils/WorldGenUtils.h"
+#include "world/generation/utils/TileSet.h"
 #include <random>
 #include <vector>
-#include <unordered_set>
 
 namespace cozy::world
 {
     namespace rivers
     {
+        // Tiles with a lower in-bounds 4-neighbour; carving turns these into waterfalls
+        using CliffDropMask = Town::TerrainMaskSet::Board;
+
         // Public API functions
         void CarveRiverSection(
             Town &town,
             int center_x,
             int center_z,
             int half_width,
-            std::unordered_set<glm::ivec2, utils::PairHash> &painted_tracker);
+            const CliffDropMask &cliff_drops,
+            utils::TileSet &painted_tracker);
         void CreateRiverMouths(Town &town, std::mt19937_64 &rng);
         void Execute(Town &town, std::mt19937_64 &rng, const TownConfig &config);
 
@@ -26,7 +30,8 @@ namespace cozy::world
         int GetBaseRiverX(int z, const std::vector<int> &column_targets);
         int ApplyCornerRounding(int z, int base_x, const std::vector<int> &column_targets);
         void FillGaps(Town &town, int from_x, int to_x, int z, int half_width,
-                      std::unordered_set<glm::ivec2, utils::PairHash> &tracker);
+                      const CliffDropMask &cliff_drops,
+                      utils::TileSet &tracker);
         bool CheckPathValid(const Town &town, int acre_z, int entry_col, int exit_col);
     }
 }
\ No newline at end of file
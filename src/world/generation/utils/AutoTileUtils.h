@@ -62,9 +62,11 @@ namespace cozy::world::utils
 
     inline int CalculatePondBlobIndex(const Town &town, int x, int z)
     {
+        // Out-of-bounds neighbours read as clear bits, matching EMPTY (non-water)
+        const auto &water = town.Masks().Get(TerrainClass::Water);
         auto pondPredicate = [&](int nx, int nz)
         {
-            return utils::IsAnyWater(utils::GetTileTypeSafe(town, nx, nz));
+            return water.Test(nx, nz);
         };
         uint8_t rawMask = Calculate8BitMask(x, z, pondPredicate);
         return GetBlobIndex(rawMask);
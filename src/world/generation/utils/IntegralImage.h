@@ -0,0 +1,106 @@
+#pragma once
+#include "world/Town.h"
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <cstdint>
+
+namespace cozy::world::utils
+{
+    // Summed-area table over the world tile grid. Build it once from tile
+    // predicates (or terrain masks) and any axis-aligned rectangle count is four
+    // lookups, however large the rectangle. Rebuild whenever the tiles the
+    // predicates read have changed.
+    //
+    // Up to four predicates ("channels") share one table: each running sum is a
+    // word holding one 16-bit count per channel, so building for several
+    // predicates costs a single pass.
+    class IntegralImage
+    {
+    public:
+        static constexpr int WIDTH = Town::TILES_X;
+        static constexpr int HEIGHT = Town::TILES_Z;
+        static constexpr int MAX_CHANNELS = 4;
+        static_assert(WIDTH * HEIGHT <= UINT16_MAX, "per-channel counts must fit 16 bits");
+
+        using Board = Town::TerrainMaskSet::Board;
+
+        // classify(x, z) returns the tile's channel bits (bit c set = counts
+        // towards channel c); called once per tile in row-major order
+        template <typename Classifier>
+        void Build(Classifier &&classify)
+        {
+            for (int z = 0; z < HEIGHT; ++z)
+            {
+                const uint64_t *above = &m_sums[Index(1, z)];
+                uint64_t *out = &m_sums[Index(1, z + 1)];
+                uint64_t row_sum = 0;
+                for (int x = 0; x < WIDTH; ++x)
+                {
+                    row_sum += SpreadChannels(static_cast<uint32_t>(classify(x, z)));
+                    out[x] = above[x] + row_sum;
+                }
+            }
+        }
+
+        // Channel c counts the set bits of masks[c]
+        void BuildFromMasks(std::initializer_list<const Board *> masks)
+        {
+            const Board *boards[MAX_CHANNELS] = {};
+            int channels = 0;
+            for (const Board *mask : masks)
+            {
+                if (channels < MAX_CHANNELS)
+                    boards[channels++] = mask;
+            }
+
+            Build([&](int x, int z)
+                  {
+                      uint32_t bits = 0;
+                      for (int c = 0; c < channels; ++c)
+                          bits |= static_cast<uint32_t>((boards[c]->Row(z)[x >> 6] >> (x & 63)) & 1ULL) << c;
+                      return bits; });
+        }
+
+        // Number of tiles in the inclusive rectangle (clipped to the grid) that
+        // count towards `channel`
+        int Count(int min_x, int min_z, int max_x, int max_z, int channel = 0) const
+        {
+            min_x = std::max(min_x, 0);
+            min_z = std::max(min_z, 0);
+            max_x = std::min(max_x, WIDTH - 1);
+            max_z = std::min(max_z, HEIGHT - 1);
+            if (min_x > max_x || min_z > max_z)
+                return 0;
+
+            // Every lane's count is non-negative and below 2^16, so the packed
+            // words can be combined with plain wrapping arithmetic
+            const uint64_t packed = m_sums[Index(max_x + 1, max_z + 1)] - m_sums[Index(min_x, max_z + 1)] -
+                                    m_sums[Index(max_x + 1, min_z)] + m_sums[Index(min_x, min_z)];
+            return static_cast<int>((packed >> (16 * channel)) & 0xFFFF);
+        }
+
+        bool Any(int min_x, int min_z, int max_x, int max_z, int channel = 0) const
+        {
+            return Count(min_x, min_z, max_x, max_z, channel) > 0;
+        }
+
+    private:
+        // Sums are stored with a zero guard row and column: entry (x, z) holds the
+        // counts over tiles [0, x) x [0, z)
+        static constexpr int Index(int x, int z) { return z * (WIDTH + 1) + x; }
+
+        // Channel bits -> one unit in each selected 16-bit lane
+        static uint64_t SpreadChannels(uint32_t bits)
+        {
+            static constexpr uint64_t LANES[16] = {
+                0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000010000ULL, 0x0000000000010001ULL,
+                0x0000000100000000ULL, 0x0000000100000001ULL, 0x0000000100010000ULL, 0x0000000100010001ULL,
+                0x0001000000000000ULL, 0x0001000000000001ULL, 0x0001000000010000ULL, 0x0001000000010001ULL,
+                0x0001000100000000ULL, 0x0001000100000001ULL, 0x0001000100010000ULL, 0x0001000100010001ULL};
+            return LANES[bits & 15u];
+        }
+
+        std::array<uint64_t, (WIDTH + 1) * (HEIGHT + 1)> m_sums{};
+    };
+}
@@ -0,0 +1,197 @@
+#include "WorldGenUtils.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COZY_NOISE_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COZY_NOISE_SSE2 1
+#endif
+
+// Vector versions of SmoothNoise. Every lane performs exactly the scalar
+// sequence of IEEE operations (no reassociation, no FMA: the world library is
+// built with contraction off), so results are bit-identical to SmoothNoise and
+// existing seeds reproduce the same towns on every path.
+
+namespace cozy::world::utils
+{
+    namespace
+    {
+        // Noise2D returns 1 - (hash & 0x7fffffff) / 2^30; dividing by a power of two
+        // is exact, so multiplying by the reciprocal gives the same float
+        constexpr float INV_2_POW_30 = 1.0f / 1073741824.0f;
+
+#if COZY_NOISE_SSE2
+        // SSE2 has no 32-bit low multiply; build it from the two 32x32->64 products
+        inline __m128i Mullo32(__m128i a, __m128i b)
+        {
+            const __m128i even = _mm_mul_epu32(a, b);
+            const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                      _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+
+        // (int)std::floor(x) for in-range x: truncate, then step down where that rounded up
+        inline __m128i FloorToInt(__m128 x)
+        {
+            const __m128i truncated = _mm_cvttps_epi32(x);
+            const __m128 rounded_up = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x);
+            return _mm_add_epi32(truncated, _mm_castps_si128(rounded_up));
+        }
+
+        inline __m128 Noise2D4(__m128i x, __m128i z, __m128i seed_term)
+        {
+            __m128i n = _mm_add_epi32(_mm_add_epi32(x, Mullo32(z, _mm_set1_epi32(57))), seed_term);
+            n = _mm_xor_si128(_mm_slli_epi32(n, 13), n);
+
+            __m128i h = Mullo32(Mullo32(n, n), _mm_set1_epi32(15731));
+            h = _mm_add_epi32(h, _mm_set1_epi32(789221));
+            h = _mm_add_epi32(Mullo32(n, h), _mm_set1_epi32(1376312589));
+            h = _mm_and_si128(h, _mm_set1_epi32(0x7fffffff));
+
+            const __m128 scaled = _mm_mul_ps(_mm_cvtepi32_ps(h), _mm_set1_ps(INV_2_POW_30));
+            return _mm_sub_ps(_mm_set1_ps(1.0f), scaled);
+        }
+
+        inline __m128 SmoothStep4(__m128 t)
+        {
+            return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t)));
+        }
+
+        inline __m128 Lerp4(__m128 a, __m128 b, __m128 t)
+        {
+            return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+        }
+
+        inline __m128 SmoothNoise4(__m128 x, __m128 z, __m128i seed_term)
+        {
+            const __m128i xi = FloorToInt(x);
+            const __m128i zi = FloorToInt(z);
+            const __m128 xf = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+            const __m128 zf = _mm_sub_ps(z, _mm_cvtepi32_ps(zi));
+
+            const __m128i one = _mm_set1_epi32(1);
+            const __m128i xi1 = _mm_add_epi32(xi, one);
+            const __m128i zi1 = _mm_add_epi32(zi, one);
+            const __m128 v1 = Noise2D4(xi, zi, seed_term);
+            const __m128 v2 = Noise2D4(xi1, zi, seed_term);
+            const __m128 v3 = Noise2D4(xi, zi1, seed_term);
+            const __m128 v4 = Noise2D4(xi1, zi1, seed_term);
+
+            const __m128 sx = SmoothStep4(xf);
+            const __m128 i1 = Lerp4(v1, v2, sx);
+            const __m128 i2 = Lerp4(v3, v4, sx);
+            return Lerp4(i1, i2, SmoothStep4(zf));
+        }
+#endif
+
+#if COZY_NOISE_AVX2
+        inline __m256 Noise2D8(__m256i x, __m256i z, __m256i seed_term)
+        {
+            __m256i n = _mm256_add_epi32(_mm256_add_epi32(x, _mm256_mullo_epi32(z, _mm256_set1_epi32(57))), seed_term);
+            n = _mm256_xor_si256(_mm256_slli_epi32(n, 13), n);
+
+            __m256i h = _mm256_mullo_epi32(_mm256_mullo_epi32(n, n), _mm256_set1_epi32(15731));
+            h = _mm256_add_epi32(h, _mm256_set1_epi32(789221));
+            h = _mm256_add_epi32(_mm256_mullo_epi32(n, h), _mm256_set1_epi32(1376312589));
+            h = _mm256_and_si256(h, _mm256_set1_epi32(0x7fffffff));
+
+            const __m256 scaled = _mm256_mul_ps(_mm256_cvtepi32_ps(h), _mm256_set1_ps(INV_2_POW_30));
+            return _mm256_sub_ps(_mm256_set1_ps(1.0f), scaled);
+        }
+
+        inline __m256 SmoothStep8(__m256 t)
+        {
+            return _mm256_mul_ps(_mm256_mul_ps(t, t),
+                                 _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t)));
+        }
+
+        inline __m256 Lerp8(__m256 a, __m256 b, __m256 t)
+        {
+            return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+        }
+
+        inline __m256 SmoothNoise8(__m256 x, __m256 z, __m256i seed_term)
+        {
+            const __m256 x_floor = _mm256_floor_ps(x);
+            const __m256 z_floor = _mm256_floor_ps(z);
+            const __m256i xi = _mm256_cvttps_epi32(x_floor);
+            const __m256i zi = _mm256_cvttps_epi32(z_floor);
+            const __m256 xf = _mm256_sub_ps(x, _mm256_cvtepi32_ps(xi));
+            const __m256 zf = _mm256_sub_ps(z, _mm256_cvtepi32_ps(zi));
+
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i xi1 = _mm256_add_epi32(xi, one);
+            const __m256i zi1 = _mm256_add_epi32(zi, one);
+            const __m256 v1 = Noise2D8(xi, zi, seed_term);
+            const __m256 v2 = Noise2D8(xi1, zi, seed_term);
+            const __m256 v3 = Noise2D8(xi, zi1, seed_term);
+            const __m256 v4 = Noise2D8(xi1, zi1, seed_term);
+
+            const __m256 sx = SmoothStep8(xf);
+            const __m256 i1 = Lerp8(v1, v2, sx);
+            const __m256 i2 = Lerp8(v3, v4, sx);
+            return Lerp8(i1, i2, SmoothStep8(zf));
+        }
+#endif
+
+        // seed * 131, wrapped like the scalar hash's uint32_t arithmetic
+        inline int SeedTerm(int seed)
+        {
+            return static_cast<int>(static_cast<unsigned>(seed) * 131u);
+        }
+    }
+
+    void SmoothNoiseBatch(const float *xs, const float *zs, int count, int seed, float *out)
+    {
+        int i = 0;
+#if COZY_NOISE_AVX2
+        const __m256i seed_term8 = _mm256_set1_epi32(SeedTerm(seed));
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(out + i, SmoothNoise8(_mm256_loadu_ps(xs + i), _mm256_loadu_ps(zs + i), seed_term8));
+#endif
+#if COZY_NOISE_SSE2
+        const __m128i seed_term4 = _mm_set1_epi32(SeedTerm(seed));
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, SmoothNoise4(_mm_loadu_ps(xs + i), _mm_loadu_ps(zs + i), seed_term4));
+#endif
+        for (; i < count; ++i)
+            out[i] = SmoothNoise(xs[i], zs[i], seed);
+    }
+
+    void SmoothNoiseRow(int wx0, int wz, int count, float scale, int seed, float *out)
+    {
+        // Sample positions are formed exactly as the scalar call sites do:
+        // (float)wx * scale, never by accumulating a step
+        const float z = static_cast<float>(wz) * scale;
+        int i = 0;
+#if COZY_NOISE_AVX2
+        const __m256i seed_term8 = _mm256_set1_epi32(SeedTerm(seed));
+        const __m256 scale8 = _mm256_set1_ps(scale);
+        const __m256 z8 = _mm256_set1_ps(z);
+        const __m256i lane8 = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i wx = _mm256_add_epi32(_mm256_set1_epi32(wx0 + i), lane8);
+            const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(wx), scale8);
+            _mm256_storeu_ps(out + i, SmoothNoise8(x, z8, seed_term8));
+        }
+#endif
+#if COZY_NOISE_SSE2
+        const __m128i seed_term4 = _mm_set1_epi32(SeedTerm(seed));
+        const __m128 scale4 = _mm_set1_ps(scale);
+        const __m128 z4 = _mm_set1_ps(z);
+        const __m128i lane4 = _mm_setr_epi32(0, 1, 2, 3);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i wx = _mm_add_epi32(_mm_set1_epi32(wx0 + i), lane4);
+            const __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(wx), scale4);
+            _mm_storeu_ps(out + i, SmoothNoise4(x, z4, seed_term4));
+        }
+#endif
+        for (; i < count; ++i)
+            out[i] = SmoothNoise(static_cast<float>(wx0 + i) * scale, z, seed);
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "world/Town.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace cozy::world::utils
+{
+    // Set of world tile coordinates with O(1) insert/erase/contains and
+    // insertion-ordered iteration. Membership is a world-sized bitset; members
+    // are kept in a dense list and each tile remembers its slot there. Erasing
+    // leaves a hole that iteration skips (compacted once holes dominate), so the
+    // order never depends on hashing or the standard library.
+    // Coordinates must be on the map, and Erase may compact the list, so don't
+    // erase while iterating.
+    class TileSet
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            const_iterator(const glm::ivec2 *pos, const glm::ivec2 *end) : m_pos(pos), m_end(end) { SkipHoles(); }
+
+            const glm::ivec2 &operator*() const { return *m_pos; }
+            const glm::ivec2 *operator->() const { return m_pos; }
+
+            const_iterator &operator++()
+            {
+                ++m_pos;
+                SkipHoles();
+                return *this;
+            }
+
+            bool operator==(const const_iterator &other) const { return m_pos == other.m_pos; }
+            bool operator!=(const const_iterator &other) const { return m_pos != other.m_pos; }
+
+        private:
+            void SkipHoles()
+            {
+                while (m_pos != m_end && m_pos->x == HOLE)
+                    ++m_pos;
+            }
+
+            const glm::ivec2 *m_pos;
+            const glm::ivec2 *m_end;
+        };
+
+        explicit TileSet(std::size_t expected = 0) { m_dense.reserve(expected); }
+
+        bool Contains(glm::ivec2 pos) const { return m_members.test(Town::TileIndex(pos.x, pos.y)); }
+
+        // Returns false if the tile was already present
+        bool Insert(glm::ivec2 pos)
+        {
+            const int index = Town::TileIndex(pos.x, pos.y);
+            if (m_members.test(index))
+                return false;
+
+            m_members.set(index);
+            m_slots[index] = static_cast<uint16_t>(m_dense.size());
+            m_dense.push_back(pos);
+            return true;
+        }
+
+        // Returns false if the tile was not present
+        bool Erase(glm::ivec2 pos)
+        {
+            const int index = Town::TileIndex(pos.x, pos.y);
+            if (!m_members.test(index))
+                return false;
+
+            m_members.reset(index);
+            m_dense[m_slots[index]].x = HOLE;
+            ++m_holes;
+            if (m_holes > m_dense.size() / 2)
+                Compact();
+            return true;
+        }
+
+        void Clear()
+        {
+            for (const glm::ivec2 &pos : m_dense)
+            {
+                if (pos.x != HOLE)
+                    m_members.reset(Town::TileIndex(pos.x, pos.y));
+            }
+            m_dense.clear();
+            m_holes = 0;
+        }
+
+        std::size_t Size() const { return m_dense.size() - m_holes; }
+        bool Empty() const { return Size() == 0; }
+
+        const_iterator begin() const { return {m_dense.data(), m_dense.data() + m_dense.size()}; }
+        const_iterator end() const { return {m_dense.data() + m_dense.size(), m_dense.data() + m_dense.size()}; }
+
+    private:
+        static constexpr int HOLE = -1;
+
+        void Compact()
+        {
+            std::size_t out = 0;
+            for (const glm::ivec2 &pos : m_dense)
+            {
+                if (pos.x == HOLE)
+                    continue;
+                m_slots[Town::TileIndex(pos.x, pos.y)] = static_cast<uint16_t>(out);
+                m_dense[out++] = pos;
+            }
+            m_dense.resize(out);
+            m_holes = 0;
+        }
+
+        std::bitset<Town::TILE_COUNT> m_members;
+        // Holes never outnumber members, so slots stay below 2 * TILE_COUNT
+        static_assert(2 * Town::TILE_COUNT <= UINT16_MAX, "dense slots must fit 16 bits");
+        std::array<uint16_t, Town::TILE_COUNT> m_slots; // Valid only where m_members is set
+        std::vector<glm::ivec2> m_dense;
+        std::size_t m_holes = 0;
+    };
+}
@@ -1,59 +1,21 @@
 #include "WorldGenUtils.h"
 #include "world/Town.h"
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 namespace cozy::world::utils
 {
-    int GetWorldWidth() { return Town::WIDTH * Acre::SIZE; }
-    int GetWorldHeight() { return Town::HEIGHT * Acre::SIZE; }
-
-    int GetElevation(const Town &town, int x, int z)
-    {
-        if (!IsInBounds(x, z))
-            return -1;
-        auto [a, l] = WorldToTile(x, z);
-        return town.GetAcre(a.x, a.y).tiles[l.y][l.x].elevation;
-    }
-
-    TileType GetTileTypeSafe(const Town &town, int wx, int wz)
-    {
-        if (!IsInBounds(wx, wz))
-            return TileType::EMPTY;
-        auto [a, l] = WorldToTile(wx, wz);
-        return town.GetAcre(a.x, a.y).tiles[l.y][l.x].type;
-    }
-
-    Tile *GetTileSafe(Town &town, int wx, int wz)
-    {
-        if (!IsInBounds(wx, wz))
-            return nullptr;
-        auto [a, l] = WorldToTile(wx, wz);
-        return &town.GetAcre(a.x, a.y).tiles[l.y][l.x];
-    }
-
-    std::vector<glm::ivec2> GetNeighbors4(int wx, int wz)
-    {
-        return {{wx + 1, wz}, {wx - 1, wz}, {wx, wz + 1}, {wx, wz - 1}};
-    }
-
-    std::vector<glm::ivec2> GetNeighbors8(int wx, int wz)
-    {
-        std::vector<glm::ivec2> n;
-        for (int dz = -1; dz <= 1; ++dz)
-            for (int dx = -1; dx <= 1; ++dx)
-                if (dx != 0 || dz != 0)
-                    n.push_back({wx + dx, wz + dz});
-        return n;
-    }
-
     float SmoothStep(float t) { return t * t * (3.0f - 2.0f * t); }
 
     float Noise2D(int x, int z, int seed)
     {
-        int n = x + z * 57 + seed * 131;
+        // Hashed in uint32_t so the arithmetic wraps instead of overflowing;
+        // the bits match the original signed formulation
+        uint32_t n = static_cast<uint32_t>(x) + static_cast<uint32_t>(z) * 57u + static_cast<uint32_t>(seed) * 131u;
         n = (n << 13) ^ n;
-        return (1.0f - ((n * (n * n * 15731 + 789221) + 1376312589) & 0x7fffffff) / 1073741824.0f);
+        const uint32_t hash = (n * (n * n * 15731u + 789221u) + 1376312589u) & 0x7fffffffu;
+        return 1.0f - static_cast<float>(hash) / 1073741824.0f;
     }
 
     float SmoothNoise(float x, float z, int seed)
@@ -86,7 +48,7 @@ namespace cozy::world::utils
                 if (final_x < 0 || final_x >= tw)
                     continue;
 
-                if (auto *tile = GetTileSafe(town, final_x, row * Acre::SIZE + sz + dz))
+                if (auto tile = GetTileSafe(town, final_x, row * Acre::SIZE + sz + dz))
                     tile->type = TileType::GRASS;
             }
         }
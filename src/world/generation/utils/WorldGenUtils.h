@@ -1,34 +1,132 @@
 #pragma once
 #include "world/data/Tile.h"
 #include "world/data/Acre.h"
+#include "world/Town.h"
 #include <glm/glm.hpp>
+#include <optional>
 #include <utility>
 #include <vector>
-#include <functional>
-
-namespace cozy::world
-{
-    class Town;
-}
 
 namespace cozy::world::utils
 {
-    // --- Hashing ---
-    struct PairHash
+    // --- Dimension Helpers ---
+    constexpr int GetWorldWidth() { return Town::TILES_X; }
+    constexpr int GetWorldHeight() { return Town::TILES_Z; }
+
+    constexpr bool IsInBounds(int wx, int wz)
     {
-        std::size_t operator()(const glm::ivec2 &v) const
+        return wx >= 0 && wx < GetWorldWidth() && wz >= 0 && wz < GetWorldHeight();
+    }
+
+    // --- Neighbor Iteration ---
+    // Compile-time offset tables and allocation-free visitors. Tiles at least
+    // one tile away from every edge take an unchecked fast path; border tiles
+    // only visit in-bounds neighbors.
+    struct NeighborOffset
+    {
+        int dx;
+        int dz;
+    };
+
+    inline constexpr NeighborOffset NEIGHBORS_4[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    inline constexpr NeighborOffset NEIGHBORS_8[8] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0},
+                                                      {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+    // True when every tile within `padding` of (wx, wz) is on the map
+    constexpr bool IsInterior(int wx, int wz, int padding = 1)
+    {
+        return wx >= padding && wx < GetWorldWidth() - padding &&
+               wz >= padding && wz < GetWorldHeight() - padding;
+    }
+
+    namespace detail
+    {
+        template <std::size_t N, typename Visit>
+        inline void ForEachOffset(const NeighborOffset (&offsets)[N], int wx, int wz, Visit &&visit)
         {
-            return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
+            if (IsInterior(wx, wz))
+            {
+                for (const NeighborOffset &o : offsets)
+                    visit(wx + o.dx, wz + o.dz);
+                return;
+            }
+            for (const NeighborOffset &o : offsets)
+            {
+                if (IsInBounds(wx + o.dx, wz + o.dz))
+                    visit(wx + o.dx, wz + o.dz);
+            }
         }
-    };
 
-    // --- Dimension Helpers ---
-    int GetWorldWidth();
-    int GetWorldHeight();
+        template <std::size_t N, typename Predicate>
+        inline bool AnyOffset(const NeighborOffset (&offsets)[N], int wx, int wz, Predicate &&pred)
+        {
+            const bool interior = IsInterior(wx, wz);
+            for (const NeighborOffset &o : offsets)
+            {
+                const int nx = wx + o.dx;
+                const int nz = wz + o.dz;
+                if ((interior || IsInBounds(nx, nz)) && pred(nx, nz))
+                    return true;
+            }
+            return false;
+        }
 
-    inline bool IsInBounds(int wx, int wz)
+        template <std::size_t N, typename Predicate>
+        inline int CountOffsets(const NeighborOffset (&offsets)[N], int wx, int wz, Predicate &&pred, bool count_outside)
+        {
+            const bool interior = IsInterior(wx, wz);
+            int count = 0;
+            for (const NeighborOffset &o : offsets)
+            {
+                const int nx = wx + o.dx;
+                const int nz = wz + o.dz;
+                if (interior || IsInBounds(nx, nz))
+                    count += pred(nx, nz) ? 1 : 0;
+                else if (count_outside)
+                    ++count;
+            }
+            return count;
+        }
+    }
+
+    // visit(nx, nz) for each in-bounds neighbor
+    template <typename Visit>
+    inline void ForEachNeighbor4(int wx, int wz, Visit &&visit)
     {
-        return wx >= 0 && wx < GetWorldWidth() && wz >= 0 && wz < GetWorldHeight();
+        detail::ForEachOffset(NEIGHBORS_4, wx, wz, visit);
+    }
+
+    template <typename Visit>
+    inline void ForEachNeighbor8(int wx, int wz, Visit &&visit)
+    {
+        detail::ForEachOffset(NEIGHBORS_8, wx, wz, visit);
+    }
+
+    // Stops at the first in-bounds neighbor satisfying pred(nx, nz)
+    template <typename Predicate>
+    inline bool AnyNeighbor4(int wx, int wz, Predicate &&pred)
+    {
+        return detail::AnyOffset(NEIGHBORS_4, wx, wz, pred);
+    }
+
+    template <typename Predicate>
+    inline bool AnyNeighbor8(int wx, int wz, Predicate &&pred)
+    {
+        return detail::AnyOffset(NEIGHBORS_8, wx, wz, pred);
+    }
+
+    // In-bounds neighbors satisfying pred(nx, nz); off-map neighbors are added
+    // when count_outside is set (e.g. to treat the map edge as a wall)
+    template <typename Predicate>
+    inline int CountNeighbors4(int wx, int wz, Predicate &&pred, bool count_outside = false)
+    {
+        return detail::CountOffsets(NEIGHBORS_4, wx, wz, pred, count_outside);
+    }
+
+    template <typename Predicate>
+    inline int CountNeighbors8(int wx, int wz, Predicate &&pred, bool count_outside = false)
+    {
+        return detail::CountOffsets(NEIGHBORS_8, wx, wz, pred, count_outside);
     }
 
     // --- Coordinate Math (Inline for Speed) ---
@@ -50,17 +148,36 @@ namespace cozy::world::utils
                type == TileType::POND;
     }
 
-    // --- Declarations (Implemented in .cpp) ---
-    int GetElevation(const Town &town, int x, int z);
-    TileType GetTileTypeSafe(const Town &town, int wx, int wz);
-    Tile *GetTileSafe(Town &town, int wx, int wz);
+    // --- Bounds-Checked Tile Access ---
+    // Out-of-bounds reads return -1 / EMPTY / nullopt. Hot loops that are known
+    // to stay in bounds should use Town::TileAt or the per-plane rows directly.
+    inline int GetElevation(const Town &town, int x, int z)
+    {
+        return IsInBounds(x, z) ? town.ElevationRow(z)[x] : -1;
+    }
+
+    inline TileType GetTileTypeSafe(const Town &town, int wx, int wz)
+    {
+        return IsInBounds(wx, wz) ? town.TypeRow(wz)[wx] : TileType::EMPTY;
+    }
 
-    std::vector<glm::ivec2> GetNeighbors4(int wx, int wz);
-    std::vector<glm::ivec2> GetNeighbors8(int wx, int wz);
+    inline std::optional<TileRef> GetTileSafe(Town &town, int wx, int wz)
+    {
+        if (!IsInBounds(wx, wz))
+            return std::nullopt;
+        return town.TileAt(wx, wz);
+    }
 
+    // --- Declarations (Implemented in .cpp) ---
     float SmoothStep(float t);
     float Noise2D(int x, int z, int seed);
     float SmoothNoise(float x, float z, int seed);
 
+    // Batched SmoothNoise (NoiseKernels.cpp), bit-identical to the scalar version.
+    // out[i] = SmoothNoise(xs[i], zs[i], seed)
+    void SmoothNoiseBatch(const float *xs, const float *zs, int count, int seed, float *out);
+    // out[i] = SmoothNoise((wx0 + i) * scale, wz * scale, seed), one row of grid samples
+    void SmoothNoiseRow(int wx0, int wz, int count, float scale, int seed, float *out);
+
     void CreateGrassTeardrop(Town &town, int row, int cx, int sz, int mw, int d, float curve, int tw);
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COZY_HAS_MMAP 1
+#endif
+
+namespace cozy::world::io
+{
+    namespace
+    {
+        std::vector<uint8_t> ReadWholeFile(const std::string &path)
+        {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in.is_open())
+                throw std::runtime_error("Failed to open file: " + path);
+
+            const std::streamsize size = in.tellg();
+            std::vector<uint8_t> bytes(static_cast<size_t>(size));
+            in.seekg(0);
+            if (size > 0 && !in.read(reinterpret_cast<char *>(bytes.data()), size))
+                throw std::runtime_error("Failed to read file: " + path);
+            return bytes;
+        }
+    }
+
+    MappedFile::MappedFile(const std::string &path)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view)
+                {
+                    m_data = static_cast<const uint8_t *>(view);
+                    m_size = static_cast<size_t>(size.QuadPart);
+                    m_mapped = true;
+                    m_mappingHandle = mapping;
+                }
+                else
+                {
+                    CloseHandle(mapping);
+                }
+            }
+        }
+        CloseHandle(file);
+#elif COZY_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void *view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED)
+            {
+                m_data = static_cast<const uint8_t *>(view);
+                m_size = static_cast<size_t>(info.st_size);
+                m_mapped = true;
+            }
+        }
+        ::close(fd);
+#endif
+
+        if (!m_mapped)
+        {
+            // Empty files cannot be mapped, and some filesystems refuse to
+            m_buffer = ReadWholeFile(path);
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Release();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            m_size = other.m_size;
+            m_mapped = other.m_mapped;
+            m_mappingHandle = other.m_mappingHandle;
+            m_buffer = std::move(other.m_buffer);
+            m_data = m_mapped ? other.m_data : m_buffer.data();
+
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_mapped = false;
+            other.m_mappingHandle = nullptr;
+        }
+        return *this;
+    }
+
+    void MappedFile::Release() noexcept
+    {
+        if (m_mapped)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+            CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+#elif COZY_HAS_MMAP
+            ::munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+        m_mappingHandle = nullptr;
+        m_buffer.clear();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cozy::world::io
+{
+    // Read-only view of a whole file. Mapped with mmap (POSIX) or
+    // MapViewOfFile (Windows) so pages are shared with the OS cache and only
+    // touched pages are read; where mapping is unavailable the file is read
+    // into an owned buffer instead. Throws std::runtime_error if the file
+    // cannot be opened or read.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const uint8_t *Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+        bool IsMapped() const { return m_mapped; }
+
+    private:
+        void Release() noexcept;
+
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_mapped = false;
+        void *m_mappingHandle = nullptr; // Windows file-mapping object
+        std::vector<uint8_t> m_buffer;   // Fallback storage when not mapped
+    };
+}
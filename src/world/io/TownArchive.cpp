@@ -0,0 +1,472 @@
+#include "TownArchive.h"
+#include "TownSnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace cozy::world::io
+{
+    namespace
+    {
+        // Cap on the cross-town row dictionary (~16 MB of rows)
+        constexpr size_t MAX_DICTIONARY_ROWS = 1u << 16;
+        // Rows seen once; cleared when full, which only costs some repeats
+        // being stored literally once more
+        constexpr size_t MAX_CANDIDATES = 1u << 20;
+
+        constexpr int TX = Town::TILES_X;
+
+        // Rows are hashed one after another as if contiguous, which needs
+        // whole words per row (see SnapshotChecksum)
+        static_assert(TownArchiveWriter::ROW_BYTES % sizeof(uint64_t) == 0, "dictionary rows must be whole words");
+
+        // The multiply only carries bits upward, so the high half is folded in;
+        // the low half alone never sees the upper bytes of each word
+        uint32_t BlobChecksum(const uint8_t *data, size_t size)
+        {
+            const uint64_t hash = SnapshotChecksum(data, size);
+            return static_cast<uint32_t>(hash ^ (hash >> 32));
+        }
+
+        void PutVarint(std::vector<uint8_t> &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Run-length pairs (varint length, byte value) covering `count` bytes
+        void PutRuns(std::vector<uint8_t> &out, const uint8_t *values, int count)
+        {
+            for (int x = 0; x < count;)
+            {
+                int end = x + 1;
+                while (end < count && values[end] == values[x])
+                    ++end;
+                PutVarint(out, static_cast<uint64_t>(end - x));
+                out.push_back(values[x]);
+                x = end;
+            }
+        }
+
+        uint64_t ZigZag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+        int64_t UnZigZag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+        class BlobReader
+        {
+        public:
+            BlobReader(const uint8_t *data, size_t size) : m_pos(data), m_end(data + size) {}
+
+            uint8_t Byte()
+            {
+                if (m_pos >= m_end)
+                    Fail();
+                return *m_pos++;
+            }
+
+            uint64_t Varint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    const uint8_t b = Byte();
+                    value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                    if (!(b & 0x80))
+                        return value;
+                }
+                Fail();
+            }
+
+            void Runs(uint8_t *values, int count)
+            {
+                for (int x = 0; x < count;)
+                {
+                    const uint64_t length = Varint();
+                    if (length == 0 || length > static_cast<uint64_t>(count - x))
+                        Fail();
+                    std::memset(values + x, Byte(), static_cast<size_t>(length));
+                    x += static_cast<int>(length);
+                }
+            }
+
+            [[noreturn]] static void Fail()
+            {
+                throw std::runtime_error("Invalid town archive: corrupt town data");
+            }
+
+        private:
+            const uint8_t *m_pos;
+            const uint8_t *m_end;
+        };
+    }
+
+    TownArchiveWriter::TownArchiveWriter(const std::string &path)
+        : m_out(path, std::ios::binary | std::ios::trunc), m_path(path)
+    {
+        if (!m_out.is_open())
+            throw std::runtime_error("Failed to open archive file: " + path);
+
+        // Placeholder, rewritten by Finish
+        const ArchiveHeader header{};
+        m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_offset = sizeof(header);
+    }
+
+    TownArchiveWriter::~TownArchiveWriter()
+    {
+        try
+        {
+            Finish();
+        }
+        catch (...)
+        {
+            // Destructors must not throw; call Finish explicitly to see errors
+        }
+    }
+
+    int64_t TownArchiveWriter::LookupRow(const Row &row)
+    {
+        const uint64_t hash = SnapshotChecksum(row.data(), row.size());
+
+        auto found = m_dictionaryByHash.find(hash);
+        if (found != m_dictionaryByHash.end())
+        {
+            // A hash collision simply falls back to a literal row
+            if (m_dictionary[found->second] == row)
+                return found->second;
+            return -1;
+        }
+
+        if (m_dictionary.size() >= MAX_DICTIONARY_ROWS)
+            return -1;
+
+        // Second sighting: promote. The first occurrence stays literal.
+        if (m_candidates.erase(hash))
+        {
+            const uint32_t index = static_cast<uint32_t>(m_dictionary.size());
+            m_dictionary.push_back(row);
+            m_dictionaryByHash.emplace(hash, index);
+            return index;
+        }
+
+        if (m_candidates.size() >= MAX_CANDIDATES)
+            m_candidates.clear();
+        m_candidates.emplace(hash, 1);
+        return -1;
+    }
+
+    void TownArchiveWriter::Add(const Town &town)
+    {
+        BeginTown();
+        const Town::TileLayers &layers = town.Layers();
+        PutTiles(reinterpret_cast<const uint8_t *>(layers.types.data()), reinterpret_cast<const uint8_t *>(layers.elevations.data()),
+                 layers.autotileIndices.data());
+
+        // Objects, grouped by acre
+        uint64_t objectCount = 0;
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                objectCount += town.GetAcre(ax, az).objects.size();
+
+        PutVarint(m_blob, objectCount);
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                for (const ObjectConfig &object : town.GetAcre(ax, az).objects)
+                    PutObject(Town::AcreIndex(ax, az), object.pos.x, object.pos.y, object.size.x, object.size.y, object.blocks_path);
+            }
+        }
+        EndTown(town.GetSeed(), town.GetConfigHash());
+    }
+
+    void TownArchiveWriter::Add(const TownSnapshotView &snapshot)
+    {
+        BeginTown();
+        PutTiles(reinterpret_cast<const uint8_t *>(snapshot.Types()), reinterpret_cast<const uint8_t *>(snapshot.Elevations()),
+                 snapshot.AutotileIndices());
+
+        // Same acre order as Add(const Town &)
+        uint64_t objectCount = 0;
+        for (int acre = 0; acre < Town::ACRE_COUNT; ++acre)
+        {
+            uint32_t count = 0;
+            snapshot.AcreObjects(acre, count);
+            objectCount += count;
+        }
+
+        PutVarint(m_blob, objectCount);
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                const int acre = Town::AcreIndex(ax, az);
+                uint32_t count = 0;
+                const SnapshotObject *objects = snapshot.AcreObjects(acre, count);
+                for (uint32_t i = 0; i < count; ++i)
+                    PutObject(acre, objects[i].x, objects[i].z, objects[i].width, objects[i].depth, (objects[i].flags & 1) != 0);
+            }
+        }
+        EndTown(snapshot.Seed(), snapshot.ConfigHash());
+    }
+
+    void TownArchiveWriter::BeginTown()
+    {
+        if (m_finished)
+            throw std::runtime_error("Town archive already finished: " + m_path);
+        m_blob.clear();
+    }
+
+    void TownArchiveWriter::PutTiles(const uint8_t *types, const uint8_t *elevations, const uint8_t *autotiles)
+    {
+        Row row;
+        uint8_t above[TX] = {}; // Elevations of the previous row
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
+        {
+            const size_t start = static_cast<size_t>(Town::TileIndex(0, wz));
+            std::memcpy(row.data(), types + start, TX);
+            std::memcpy(row.data() + TX, elevations + start, TX);
+            std::memcpy(row.data() + 2 * TX, autotiles + start, TX);
+
+            const int64_t token = LookupRow(row);
+            if (token >= 0)
+            {
+                PutVarint(m_blob, static_cast<uint64_t>(token) + 1);
+            }
+            else
+            {
+                PutVarint(m_blob, 0);
+                uint8_t delta[TX];
+                for (int x = 0; x < TX; ++x)
+                    delta[x] = static_cast<uint8_t>(row[TX + x] - above[x]);
+
+                PutRuns(m_blob, row.data(), TX);
+                PutRuns(m_blob, delta, TX);
+                PutRuns(m_blob, row.data() + 2 * TX, TX);
+            }
+            std::memcpy(above, row.data() + TX, TX);
+        }
+    }
+
+    void TownArchiveWriter::PutObject(int acre_index, int x, int z, int width, int depth, bool blocks_path)
+    {
+        PutVarint(m_blob, static_cast<uint64_t>(acre_index));
+        PutVarint(m_blob, ZigZag(x));
+        PutVarint(m_blob, ZigZag(z));
+        PutVarint(m_blob, ZigZag(width));
+        PutVarint(m_blob, ZigZag(depth));
+        m_blob.push_back(blocks_path ? 1 : 0);
+    }
+
+    void TownArchiveWriter::EndTown(uint64_t seed, uint64_t configHash)
+    {
+        m_entries.push_back({seed, configHash, m_offset, static_cast<uint32_t>(m_blob.size()),
+                             BlobChecksum(m_blob.data(), m_blob.size())});
+        m_out.write(reinterpret_cast<const char *>(m_blob.data()), static_cast<std::streamsize>(m_blob.size()));
+        m_offset += m_blob.size();
+        if (!m_out)
+            throw std::runtime_error("Failed to write archive file: " + m_path);
+    }
+
+    void TownArchiveWriter::Finish()
+    {
+        if (m_finished)
+            return;
+        m_finished = true;
+
+        std::sort(m_entries.begin(), m_entries.end(), [](const ArchiveEntry &a, const ArchiveEntry &b)
+                  { return a.seed < b.seed; });
+        for (size_t i = 1; i < m_entries.size(); ++i)
+        {
+            if (m_entries[i].seed == m_entries[i - 1].seed)
+                throw std::runtime_error("Duplicate seed " + std::to_string(m_entries[i].seed) + " in archive " + m_path);
+        }
+
+        ArchiveHeader header{};
+        std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+        header.version = ARCHIVE_VERSION;
+        header.tilesX = Town::TILES_X;
+        header.tilesZ = Town::TILES_Z;
+        header.dictionaryRows = static_cast<uint32_t>(m_dictionary.size());
+        header.townCount = m_entries.size();
+        header.dictionaryOffset = m_offset;
+
+        header.dictionaryChecksum = SNAPSHOT_CHECKSUM_BASIS;
+        for (const Row &row : m_dictionary)
+        {
+            m_out.write(reinterpret_cast<const char *>(row.data()), ROW_BYTES);
+            header.dictionaryChecksum = SnapshotChecksum(row.data(), ROW_BYTES, header.dictionaryChecksum);
+        }
+        m_offset += m_dictionary.size() * ROW_BYTES;
+
+        // Keep the index 8-byte aligned so it can be read in place
+        const uint64_t padding = (8 - m_offset % 8) % 8;
+        const char zeros[8] = {};
+        m_out.write(zeros, static_cast<std::streamsize>(padding));
+        m_offset += padding;
+
+        header.indexOffset = m_offset;
+        header.indexChecksum = SnapshotChecksum(reinterpret_cast<const uint8_t *>(m_entries.data()),
+                                                m_entries.size() * sizeof(ArchiveEntry));
+        m_out.write(reinterpret_cast<const char *>(m_entries.data()), static_cast<std::streamsize>(m_entries.size() * sizeof(ArchiveEntry)));
+        m_offset += m_entries.size() * sizeof(ArchiveEntry);
+        header.fileSize = m_offset;
+
+        m_out.seekp(0);
+        m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_out.close();
+        if (!m_out)
+            throw std::runtime_error("Failed to write archive file: " + m_path);
+    }
+
+    TownArchive::TownArchive(const std::string &path)
+        : m_file(path)
+    {
+        auto fail = [&](const std::string &why)
+        {
+            throw std::runtime_error("Invalid town archive " + path + ": " + why);
+        };
+
+        const uint8_t *data = m_file.Data();
+        const size_t size = m_file.Size();
+        if (size < sizeof(ArchiveHeader))
+            fail("file too small for header");
+
+        m_header = reinterpret_cast<const ArchiveHeader *>(data);
+        const ArchiveHeader &h = *m_header;
+        if (std::memcmp(h.magic, ARCHIVE_MAGIC, sizeof(h.magic)) != 0)
+            fail("bad magic");
+        if (h.version != ARCHIVE_VERSION)
+            fail("unsupported version " + std::to_string(h.version));
+        if (h.tilesX != Town::TILES_X || h.tilesZ != Town::TILES_Z)
+            fail("town dimensions differ from this build");
+        if (h.fileSize != size || h.dictionaryOffset > size ||
+            h.dictionaryRows > (size - h.dictionaryOffset) / TownArchiveWriter::ROW_BYTES ||
+            h.indexOffset % 8 != 0 || h.indexOffset > size ||
+            h.townCount > (size - h.indexOffset) / sizeof(ArchiveEntry))
+            fail("size mismatch (truncated file?)");
+
+        m_dictionary = data + h.dictionaryOffset;
+        m_index = reinterpret_cast<const ArchiveEntry *>(data + h.indexOffset);
+
+        // The index and dictionary are trusted from here on; blobs are checked
+        // as they are loaded
+        if (SnapshotChecksum(m_dictionary, static_cast<size_t>(h.dictionaryRows) * TownArchiveWriter::ROW_BYTES) != h.dictionaryChecksum)
+            fail("dictionary checksum mismatch");
+        if (SnapshotChecksum(data + h.indexOffset, static_cast<size_t>(h.townCount) * sizeof(ArchiveEntry)) != h.indexChecksum)
+            fail("index checksum mismatch");
+        for (uint64_t i = 1; i < h.townCount; ++i)
+        {
+            if (m_index[i].seed <= m_index[i - 1].seed)
+                fail("index is not sorted by seed");
+        }
+    }
+
+    const ArchiveEntry *TownArchive::Find(uint64_t seed) const
+    {
+        const ArchiveEntry *end = m_index + m_header->townCount;
+        const ArchiveEntry *it = std::lower_bound(m_index, end, seed, [](const ArchiveEntry &entry, uint64_t s)
+                                                  { return entry.seed < s; });
+        return (it != end && it->seed == seed) ? it : nullptr;
+    }
+
+    bool TownArchive::Load(uint64_t seed, Town &town) const
+    {
+        const ArchiveEntry *entry = Find(seed);
+        if (!entry)
+            return false;
+        Load(*entry, town);
+        return true;
+    }
+
+    void TownArchive::Load(const ArchiveEntry &entry, Town &town) const
+    {
+        // Blobs lie between the header and the dictionary; written so a corrupt
+        // offset can't wrap the sum past the check
+        if (entry.offset < sizeof(ArchiveHeader) || entry.offset > m_header->dictionaryOffset ||
+            entry.size > m_header->dictionaryOffset - entry.offset)
+            BlobReader::Fail();
+
+        const uint8_t *blob = m_file.Data() + entry.offset;
+        if (BlobChecksum(blob, entry.size) != entry.checksum)
+            throw std::runtime_error("Invalid town archive: checksum mismatch for seed " + std::to_string(entry.seed));
+
+        // Decoded in full before `town` is touched, so a blob that fails
+        // halfway leaves the caller's town as it was
+        auto layers = std::make_unique<Town::TileLayers>();
+        uint8_t *types = reinterpret_cast<uint8_t *>(layers->types.data());
+        uint8_t *elevations = reinterpret_cast<uint8_t *>(layers->elevations.data());
+        uint8_t *autotile = layers->autotileIndices.data();
+
+        BlobReader in(blob, entry.size);
+        const uint8_t zeros[TX] = {};
+        const uint8_t *above = zeros; // Elevations of the previous row, for the deltas
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
+        {
+            const size_t start = static_cast<size_t>(Town::TileIndex(0, wz));
+            const uint64_t token = in.Varint();
+            if (token > 0)
+            {
+                if (token > m_header->dictionaryRows)
+                    BlobReader::Fail();
+                const uint8_t *row = m_dictionary + (token - 1) * TownArchiveWriter::ROW_BYTES;
+                std::memcpy(types + start, row, TX);
+                std::memcpy(elevations + start, row + TX, TX);
+                std::memcpy(autotile + start, row + 2 * TX, TX);
+            }
+            else
+            {
+                in.Runs(types + start, TX);
+                in.Runs(elevations + start, TX);
+                in.Runs(autotile + start, TX);
+                for (int x = 0; x < TX; ++x)
+                    elevations[start + x] = static_cast<uint8_t>(above[x] + elevations[start + x]);
+            }
+            above = elevations + start;
+
+            for (int x = 0; x < TX; ++x)
+            {
+                if (types[start + x] > static_cast<uint8_t>(TileType::RAMP))
+                    BlobReader::Fail();
+            }
+        }
+
+        std::vector<std::pair<int, ObjectConfig>> objects; // (AcreIndex, object)
+        const uint64_t objectCount = in.Varint();
+        for (uint64_t i = 0; i < objectCount; ++i)
+        {
+            const uint64_t acre = in.Varint();
+            if (acre >= static_cast<uint64_t>(Town::ACRE_COUNT))
+                BlobReader::Fail();
+
+            ObjectConfig object;
+            object.pos.x = static_cast<int>(UnZigZag(in.Varint()));
+            object.pos.y = static_cast<int>(UnZigZag(in.Varint()));
+            object.size.x = static_cast<int>(UnZigZag(in.Varint()));
+            object.size.y = static_cast<int>(UnZigZag(in.Varint()));
+            object.blocks_path = (in.Byte() & 1u) != 0;
+            objects.emplace_back(static_cast<int>(acre), object);
+        }
+
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
+        {
+            const size_t start = static_cast<size_t>(Town::TileIndex(0, wz));
+            std::memcpy(town.MutableTypeRow(wz), types + start, TX);
+            std::memcpy(town.MutableElevationRow(wz), elevations + start, TX);
+            std::memcpy(town.MutableAutotileRow(wz), autotile + start, TX);
+        }
+
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                town.GetAcre(ax, az).objects.clear();
+        // AcreIndex is ax * HEIGHT + az
+        for (const auto &[acre, object] : objects)
+            town.GetAcre(acre / Town::HEIGHT, acre % Town::HEIGHT).objects.push_back(object);
+
+        town.SetGenerationInfo(entry.seed, entry.configHash);
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "world/Town.h"
+#include "MappedFile.h"
+#include "TownSnapshot.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cozy::world::io
+{
+    // Many towns in one file, compressed and indexed by seed. Version 2:
+    //
+    //   ArchiveHeader
+    //   town blobs        one per town, in the order they were added
+    //   row dictionary    dictionaryRows x ROW_BYTES
+    //   index             townCount x ArchiveEntry, sorted by seed
+    //
+    // A town is encoded row by row (one row = the types, elevations and
+    // autotile indices of one z line). Each row is either a reference into the
+    // row dictionary (shared across towns: ocean, beach and plain grass rows
+    // repeat constantly) or a literal: types and autotile indices run-length
+    // encoded, elevations as the run-length encoded delta to the row above.
+    // The index is read in place, so finding a town is a binary search in
+    // memory and loading it touches one contiguous blob.
+    //
+    // Every byte is covered by a SnapshotChecksum: the header holds those of
+    // the dictionary and the index (checked when the archive is opened), and
+    // each index entry holds that of its blob (checked when it is loaded).
+    constexpr char ARCHIVE_MAGIC[4] = {'C', 'Z', 'T', 'A'};
+    constexpr uint16_t ARCHIVE_VERSION = 2; // 2: dictionary, index and blob checksums
+
+    struct ArchiveHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved0;
+        uint16_t tilesX;
+        uint16_t tilesZ;
+        uint32_t dictionaryRows;
+        uint64_t townCount;
+        uint64_t dictionaryOffset;
+        uint64_t indexOffset;
+        uint64_t fileSize;
+        uint64_t dictionaryChecksum; // Over dictionaryRows x ROW_BYTES
+        uint64_t indexChecksum;      // Over townCount x ArchiveEntry
+    };
+
+    struct ArchiveEntry
+    {
+        uint64_t seed;
+        uint64_t configHash;
+        uint64_t offset; // Of the town blob, from the start of the file
+        uint32_t size;
+        uint32_t checksum; // SnapshotChecksum over the blob, folded to 32 bits
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 64, "archive header layout is part of the file format");
+    static_assert(sizeof(ArchiveEntry) == 32, "archive entry layout is part of the file format");
+
+    // Streams towns into an archive. Blobs are written as towns arrive, so
+    // memory stays bounded by the index and the row dictionary, however many
+    // towns go in. Throws std::runtime_error on I/O failure.
+    class TownArchiveWriter
+    {
+    public:
+        static constexpr int ROW_BYTES = 3 * Town::TILES_X;
+
+        explicit TownArchiveWriter(const std::string &path);
+        ~TownArchiveWriter();
+
+        TownArchiveWriter(const TownArchiveWriter &) = delete;
+        TownArchiveWriter &operator=(const TownArchiveWriter &) = delete;
+
+        // Seeds must be unique within an archive
+        void Add(const Town &town);
+
+        // Same encoding from a snapshot, so finished towns can be parked as
+        // bytes and added later in a fixed order
+        void Add(const TownSnapshotView &snapshot);
+
+        // Writes the dictionary, index and header; called by the destructor if needed
+        void Finish();
+
+        uint64_t TownCount() const { return m_entries.size(); }
+        uint64_t BytesWritten() const { return m_offset; }
+
+    private:
+        using Row = std::array<uint8_t, ROW_BYTES>;
+
+        // Dictionary index for the row, promoting it once it has been seen
+        // twice; -1 while it is still a candidate
+        int64_t LookupRow(const Row &row);
+
+        // Encoding steps shared by both Add overloads; planes are row-major
+        // TILE_COUNT bytes each, as in Town::TileLayers
+        void BeginTown();
+        void PutTiles(const uint8_t *types, const uint8_t *elevations, const uint8_t *autotiles);
+        void PutObject(int acre_index, int x, int z, int width, int depth, bool blocks_path);
+        void EndTown(uint64_t seed, uint64_t configHash);
+
+        std::ofstream m_out;
+        std::string m_path;
+        uint64_t m_offset = 0;
+        bool m_finished = false;
+
+        std::vector<ArchiveEntry> m_entries;
+        std::vector<Row> m_dictionary;
+        std::unordered_map<uint64_t, uint32_t> m_dictionaryByHash; // Row hash -> dictionary index
+        // Hashes of rows seen once; bounded so huge archives don't grow it forever
+        std::unordered_map<uint64_t, uint8_t> m_candidates;
+        std::vector<uint8_t> m_blob; // Scratch for the town being encoded
+    };
+
+    // Read-only archive over a mapped file
+    class TownArchive
+    {
+    public:
+        // Throws std::runtime_error on a malformed, corrupt or mismatched file
+        explicit TownArchive(const std::string &path);
+
+        uint64_t Size() const { return m_header->townCount; }
+        const ArchiveEntry &EntryAt(uint64_t i) const { return m_index[i]; }
+
+        // nullptr when the seed is not in the archive
+        const ArchiveEntry *Find(uint64_t seed) const;
+
+        // Decodes a town's tiles into `town`; returns false if the seed is
+        // missing. Throws std::runtime_error on a corrupt blob, leaving `town`
+        // untouched.
+        bool Load(uint64_t seed, Town &town) const;
+        void Load(const ArchiveEntry &entry, Town &town) const;
+
+    private:
+        MappedFile m_file;
+        const ArchiveHeader *m_header = nullptr;
+        const ArchiveEntry *m_index = nullptr;
+        const uint8_t *m_dictionary = nullptr;
+    };
+}
@@ -0,0 +1,231 @@
+#include "TownSnapshot.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace cozy::world::io
+{
+    namespace
+    {
+        constexpr size_t PLANES_BYTES = 3 * static_cast<size_t>(Town::TILE_COUNT);
+
+        constexpr size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Planes follow the header, and the acre table the planes; both are
+        // fixed-size, so only the object count varies between files
+        constexpr size_t PLANES_OFFSET = sizeof(SnapshotHeader);
+        constexpr size_t ACRE_TABLE_OFFSET = AlignUp(PLANES_OFFSET + PLANES_BYTES, alignof(SnapshotAcre));
+        constexpr size_t OBJECTS_OFFSET = AlignUp(ACRE_TABLE_OFFSET + Town::ACRE_COUNT * sizeof(SnapshotAcre), alignof(SnapshotObject));
+
+        [[noreturn]] void Fail(const std::string &why)
+        {
+            throw std::runtime_error("Invalid town snapshot: " + why);
+        }
+
+        // The header (with `checksum` zeroed) followed by everything after it
+        uint64_t FileChecksum(const SnapshotHeader &header, const uint8_t *data, size_t size)
+        {
+            SnapshotHeader zeroed = header;
+            zeroed.checksum = 0;
+            const uint64_t hash = SnapshotChecksum(reinterpret_cast<const uint8_t *>(&zeroed), sizeof(zeroed));
+            return SnapshotChecksum(data + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader), hash);
+        }
+    }
+
+    uint64_t SnapshotChecksum(const uint8_t *data, size_t size, uint64_t hash)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash ^= word;
+            hash *= 0x100000001B3ULL;
+        }
+        for (; i < size; ++i)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    std::vector<uint8_t> SerializeTown(const Town &town, bool with_checksum)
+    {
+        uint32_t objectCount = 0;
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                objectCount += static_cast<uint32_t>(town.GetAcre(ax, az).objects.size());
+
+        const size_t fileSize = OBJECTS_OFFSET + objectCount * sizeof(SnapshotObject);
+        std::vector<uint8_t> bytes(fileSize, 0);
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.flags = with_checksum ? SNAPSHOT_FLAG_CHECKSUM : 0;
+        header.seed = town.GetSeed();
+        header.configHash = town.GetConfigHash();
+        header.tilesX = Town::TILES_X;
+        header.tilesZ = Town::TILES_Z;
+        header.acreSize = Acre::SIZE;
+        header.acresX = Town::WIDTH;
+        header.acresZ = Town::HEIGHT;
+        header.planesOffset = static_cast<uint32_t>(PLANES_OFFSET);
+        header.acreTableOffset = static_cast<uint32_t>(ACRE_TABLE_OFFSET);
+        header.objectsOffset = static_cast<uint32_t>(OBJECTS_OFFSET);
+        header.objectCount = objectCount;
+        header.fileSize = static_cast<uint32_t>(fileSize);
+
+        const Town::TileLayers &layers = town.Layers();
+        uint8_t *planes = bytes.data() + PLANES_OFFSET;
+        std::memcpy(planes, layers.types.data(), Town::TILE_COUNT);
+        std::memcpy(planes + Town::TILE_COUNT, layers.elevations.data(), Town::TILE_COUNT);
+        std::memcpy(planes + 2 * Town::TILE_COUNT, layers.autotileIndices.data(), Town::TILE_COUNT);
+
+        uint32_t next = 0;
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                const std::vector<ObjectConfig> &objects = town.GetAcre(ax, az).objects;
+                const SnapshotAcre acre{next, static_cast<uint32_t>(objects.size())};
+                std::memcpy(bytes.data() + ACRE_TABLE_OFFSET + Town::AcreIndex(ax, az) * sizeof(SnapshotAcre), &acre, sizeof(acre));
+
+                for (const ObjectConfig &object : objects)
+                {
+                    SnapshotObject record{};
+                    record.x = static_cast<int16_t>(object.pos.x);
+                    record.z = static_cast<int16_t>(object.pos.y);
+                    record.width = static_cast<uint16_t>(object.size.x);
+                    record.depth = static_cast<uint16_t>(object.size.y);
+                    record.flags = object.blocks_path ? 1 : 0;
+                    std::memcpy(bytes.data() + OBJECTS_OFFSET + next * sizeof(SnapshotObject), &record, sizeof(record));
+                    ++next;
+                }
+            }
+        }
+
+        if (with_checksum)
+            header.checksum = FileChecksum(header, bytes.data(), fileSize);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        return bytes;
+    }
+
+    void WriteTownSnapshot(const Town &town, const std::string &path, bool with_checksum)
+    {
+        const std::vector<uint8_t> bytes = SerializeTown(town, with_checksum);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open snapshot file: " + path);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw std::runtime_error("Failed to write snapshot file: " + path);
+    }
+
+    TownSnapshotView::TownSnapshotView(std::shared_ptr<const MappedFile> file, const uint8_t *data, size_t size, bool verify_checksum)
+        : m_file(std::move(file)), m_data(data)
+    {
+        if (size < sizeof(SnapshotHeader))
+            Fail("file too small for header");
+        if (reinterpret_cast<uintptr_t>(data) % alignof(SnapshotHeader) != 0)
+            Fail("data is not 8-byte aligned");
+
+        m_header = reinterpret_cast<const SnapshotHeader *>(data);
+        const SnapshotHeader &h = *m_header;
+        if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0)
+            Fail("bad magic");
+        if (h.version != SNAPSHOT_VERSION)
+            Fail("unsupported version " + std::to_string(h.version));
+        if (h.tilesX != Town::TILES_X || h.tilesZ != Town::TILES_Z || h.acreSize != Acre::SIZE ||
+            h.acresX != Town::WIDTH || h.acresZ != Town::HEIGHT)
+            Fail("town dimensions differ from this build");
+        if (h.planesOffset != PLANES_OFFSET || h.acreTableOffset != ACRE_TABLE_OFFSET || h.objectsOffset != OBJECTS_OFFSET)
+            Fail("unexpected section offsets");
+        if (h.fileSize != size || h.fileSize != OBJECTS_OFFSET + static_cast<size_t>(h.objectCount) * sizeof(SnapshotObject))
+            Fail("size mismatch (truncated file?)");
+
+        if (verify_checksum && HasChecksum() &&
+            FileChecksum(h, data, size) != h.checksum)
+            Fail("checksum mismatch");
+
+        // Every byte handed out as a TileType must be a valid enumerator
+        const uint8_t *types = data + h.planesOffset;
+        uint8_t maxType = 0;
+        for (int i = 0; i < Town::TILE_COUNT; ++i)
+            maxType = types[i] > maxType ? types[i] : maxType;
+        if (maxType > static_cast<uint8_t>(TileType::RAMP))
+            Fail("unknown tile type " + std::to_string(maxType));
+
+        const SnapshotAcre *acres = reinterpret_cast<const SnapshotAcre *>(data + h.acreTableOffset);
+        for (int i = 0; i < Town::ACRE_COUNT; ++i)
+        {
+            if (static_cast<uint64_t>(acres[i].firstObject) + acres[i].objectCount > h.objectCount)
+                Fail("acre object range out of bounds");
+        }
+    }
+
+    TownSnapshotView TownSnapshotView::Open(const std::string &path, bool verify_checksum)
+    {
+        auto file = std::make_shared<const MappedFile>(path);
+        const uint8_t *data = file->Data();
+        const size_t size = file->Size();
+        return TownSnapshotView(std::move(file), data, size, verify_checksum);
+    }
+
+    TownSnapshotView TownSnapshotView::FromMemory(const uint8_t *data, size_t size, bool verify_checksum)
+    {
+        return TownSnapshotView(nullptr, data, size, verify_checksum);
+    }
+
+    const SnapshotObject *TownSnapshotView::AcreObjects(int acre_index, uint32_t &count) const
+    {
+        const SnapshotAcre &acre = reinterpret_cast<const SnapshotAcre *>(m_data + m_header->acreTableOffset)[acre_index];
+        count = acre.objectCount;
+        return reinterpret_cast<const SnapshotObject *>(m_data + m_header->objectsOffset) + acre.firstObject;
+    }
+
+    void TownSnapshotView::CopyTo(Town &town) const
+    {
+        // Whole rows through the mutable row accessors, so the terrain masks
+        // and dirty acres follow the new tiles
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
+        {
+            const size_t row = static_cast<size_t>(Town::TileIndex(0, wz));
+            std::memcpy(town.MutableTypeRow(wz), Types() + row, Town::TILES_X);
+            std::memcpy(town.MutableElevationRow(wz), Elevations() + row, Town::TILES_X);
+            std::memcpy(town.MutableAutotileRow(wz), AutotileIndices() + row, Town::TILES_X);
+        }
+
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                uint32_t count = 0;
+                const SnapshotObject *records = AcreObjects(Town::AcreIndex(ax, az), count);
+
+                std::vector<ObjectConfig> &objects = town.GetAcre(ax, az).objects;
+                objects.clear();
+                objects.reserve(count);
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const SnapshotObject &record = records[i];
+                    objects.push_back({glm::ivec2(record.x, record.z), glm::ivec2(record.width, record.depth), (record.flags & 1u) != 0});
+                }
+            }
+        }
+
+        town.SetGenerationInfo(Seed(), ConfigHash());
+    }
+
+    void LoadTownSnapshot(const std::string &path, Town &town, bool verify_checksum)
+    {
+        TownSnapshotView::Open(path, verify_checksum).CopyTo(town);
+    }
+}
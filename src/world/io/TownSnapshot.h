@@ -0,0 +1,126 @@
+#pragma once
+#include "world/Town.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cozy::world::io
+{
+    // Binary town snapshot, version 2. All fields are little-endian, like every
+    // host we ship on, so a file is read in place with no decoding:
+    //
+    //   SnapshotHeader                     64 bytes
+    //   types, elevations, autotile planes TILE_COUNT bytes each, row-major
+    //                                      (the Town::TileLayers layout)
+    //   acre table                         ACRE_COUNT x SnapshotAcre, AcreIndex order
+    //   objects                            objectCount x SnapshotObject, grouped by acre
+    //
+    // Readers reject files whose version or dimensions differ from their own;
+    // a layout change bumps SNAPSHOT_VERSION.
+    constexpr char SNAPSHOT_MAGIC[4] = {'C', 'Z', 'T', 'N'};
+    constexpr uint16_t SNAPSHOT_VERSION = 2; // 2: the checksum also covers the header
+
+    enum SnapshotFlags : uint16_t
+    {
+        SNAPSHOT_FLAG_CHECKSUM = 1u << 0 // `checksum` covers the whole file, hashed with the field itself zeroed
+    };
+
+    struct SnapshotHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t flags;
+        uint64_t seed;
+        uint64_t configHash; // TownConfig::Hash
+        uint16_t tilesX;
+        uint16_t tilesZ;
+        uint8_t acreSize;
+        uint8_t acresX;
+        uint8_t acresZ;
+        uint8_t reserved0;
+        uint32_t planesOffset;
+        uint32_t acreTableOffset;
+        uint32_t objectsOffset;
+        uint32_t objectCount;
+        uint32_t fileSize;
+        uint32_t reserved1;
+        uint64_t checksum;
+    };
+
+    struct SnapshotAcre
+    {
+        uint32_t firstObject;
+        uint32_t objectCount;
+    };
+
+    struct SnapshotObject
+    {
+        int16_t x;
+        int16_t z;
+        uint16_t width;
+        uint16_t depth;
+        uint8_t flags; // Bit 0: blocks_path
+        uint8_t reserved[3];
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 64, "snapshot header layout is part of the file format");
+    static_assert(sizeof(SnapshotAcre) == 8, "snapshot acre layout is part of the file format");
+    static_assert(sizeof(SnapshotObject) == 12, "snapshot object layout is part of the file format");
+
+    // 64-bit FNV-1a over little-endian words (bytes for the tail); eight
+    // times fewer multiplies than byte-wise FNV, so verifying is cheap at load.
+    // Passing a previous result as `hash` continues it over data split at a
+    // multiple of 8 bytes.
+    constexpr uint64_t SNAPSHOT_CHECKSUM_BASIS = 0xCBF29CE484222325ULL;
+    uint64_t SnapshotChecksum(const uint8_t *data, size_t size, uint64_t hash = SNAPSHOT_CHECKSUM_BASIS);
+
+    std::vector<uint8_t> SerializeTown(const Town &town, bool with_checksum = true);
+    void WriteTownSnapshot(const Town &town, const std::string &path, bool with_checksum = true);
+
+    // Validated, read-only view of a snapshot. Tile planes and objects are
+    // read straight from the underlying bytes, so many towns can be kept
+    // loaded without building a Town for each. Construction throws
+    // std::runtime_error on a malformed, truncated or mismatched file.
+    class TownSnapshotView
+    {
+    public:
+        // Maps the file; the view owns the mapping
+        static TownSnapshotView Open(const std::string &path, bool verify_checksum = true);
+
+        // Views caller-owned bytes, which must outlive the view
+        static TownSnapshotView FromMemory(const uint8_t *data, size_t size, bool verify_checksum = true);
+
+        uint64_t Seed() const { return m_header->seed; }
+        uint64_t ConfigHash() const { return m_header->configHash; }
+        bool HasChecksum() const { return (m_header->flags & SNAPSHOT_FLAG_CHECKSUM) != 0; }
+
+        const TileType *Types() const { return reinterpret_cast<const TileType *>(m_data + m_header->planesOffset); }
+        const int8_t *Elevations() const { return reinterpret_cast<const int8_t *>(Types() + Town::TILE_COUNT); }
+        const uint8_t *AutotileIndices() const { return reinterpret_cast<const uint8_t *>(Elevations() + Town::TILE_COUNT); }
+
+        Tile TileAt(int wx, int wz) const
+        {
+            const int i = Town::TileIndex(wx, wz);
+            return {Types()[i], Elevations()[i], AutotileIndices()[i]};
+        }
+
+        // Objects of one acre (Town::AcreIndex order)
+        const SnapshotObject *AcreObjects(int acre_index, uint32_t &count) const;
+
+        // Restores tiles, objects and generation info into `town`
+        void CopyTo(Town &town) const;
+
+    private:
+        TownSnapshotView(std::shared_ptr<const MappedFile> file, const uint8_t *data, size_t size, bool verify_checksum);
+
+        std::shared_ptr<const MappedFile> m_file; // Null for FromMemory views
+        const uint8_t *m_data = nullptr;
+        const SnapshotHeader *m_header = nullptr;
+    };
+
+    // Open + CopyTo
+    void LoadTownSnapshot(const std::string &path, Town &town, bool verify_checksum = true);
+}
@@ -0,0 +1,273 @@
+#include "TerrainMesher.h"
+#include "TownPresenter.h"
+#include "world/generation/utils/WorldGenUtils.h"
+
+namespace cozy::world
+{
+    namespace
+    {
+        // Tiles are unit cubes centred on (x, elevation, z), as in the instanced path
+        constexpr float HALF = 0.5f;
+        constexpr int SIZE = Acre::SIZE;
+
+        // Corners must be counter-clockwise seen from outside the face
+        void EmitQuad(rendering::TerrainChunk &out, const glm::vec3 (&corners)[4],
+                      const glm::vec3 &normal, const glm::vec3 &color)
+        {
+            const uint16_t base = static_cast<uint16_t>(out.vertices.size());
+            for (const glm::vec3 &corner : corners)
+                out.vertices.push_back({corner, normal, color});
+
+            const uint16_t quad[6] = {0, 1, 2, 2, 3, 0};
+            for (uint16_t i : quad)
+                out.indices.push_back(static_cast<uint16_t>(base + i));
+        }
+
+        // Top faces of the tiles [x0, x1] x [z0, z1] at height y
+        void EmitTop(rendering::TerrainChunk &out, int x0, int z0, int x1, int z1, float y, const glm::vec3 &color)
+        {
+            const float min_x = static_cast<float>(x0) - HALF;
+            const float max_x = static_cast<float>(x1) + HALF;
+            const float min_z = static_cast<float>(z0) - HALF;
+            const float max_z = static_cast<float>(z1) + HALF;
+            const glm::vec3 corners[4] = {
+                {min_x, y, max_z},
+                {max_x, y, max_z},
+                {max_x, y, min_z},
+                {min_x, y, min_z}};
+            EmitQuad(out, corners, {0.0f, 1.0f, 0.0f}, color);
+        }
+
+        // Wall on the (dx, dz) side of a run of `length` tiles starting at
+        // (x, z) and continuing along the wall, spanning bottom..top
+        void EmitWall(rendering::TerrainChunk &out, int x, int z, int length, int dx, int dz,
+                      float bottom, float top, const glm::vec3 &color)
+        {
+            const glm::vec3 normal(static_cast<float>(dx), 0.0f, static_cast<float>(dz));
+            const glm::vec3 along(normal.z != 0.0f ? 1.0f : 0.0f, 0.0f, normal.x != 0.0f ? 1.0f : 0.0f);
+            const float half_length = static_cast<float>(length) * HALF;
+            const glm::vec3 centre = glm::vec3(static_cast<float>(x), 0.0f, static_cast<float>(z)) +
+                                     along * (half_length - HALF) + normal * HALF;
+
+            // normal x up, so the corner order below winds outwards
+            const glm::vec3 tangent = glm::vec3(-normal.z, 0.0f, normal.x) * half_length;
+            const glm::vec3 corners[4] = {
+                centre + tangent + glm::vec3(0.0f, bottom, 0.0f),
+                centre - tangent + glm::vec3(0.0f, bottom, 0.0f),
+                centre - tangent + glm::vec3(0.0f, top, 0.0f),
+                centre + tangent + glm::vec3(0.0f, top, 0.0f)};
+            EmitQuad(out, corners, normal, color);
+        }
+
+        void ComputeBounds(rendering::TerrainChunk &chunk)
+        {
+            chunk.boundsMin = chunk.boundsMax = chunk.vertices.empty() ? glm::vec3(0.0f) : chunk.vertices.front().position;
+            for (const rendering::TerrainVertex &v : chunk.vertices)
+            {
+                chunk.boundsMin = glm::min(chunk.boundsMin, v.position);
+                chunk.boundsMax = glm::max(chunk.boundsMax, v.position);
+            }
+        }
+
+        // Faces only merge when their heights and colour agree
+        struct FaceKey
+        {
+            int8_t bottom = 0; // Walls only
+            int8_t top = 0;
+            uint8_t palette = 0;
+            bool present = false;
+
+            bool operator==(const FaceKey &o) const
+            {
+                return present == o.present && bottom == o.bottom && top == o.top && palette == o.palette;
+            }
+        };
+
+        // Greedy rectangle cover of the present cells of a SIZE x SIZE key grid
+        // (indexed [z][x]); emit(x0, z0, x1, z1, key) per rectangle
+        template <typename Emit>
+        void MergeRectangles(FaceKey (&keys)[SIZE][SIZE], Emit &&emit)
+        {
+            for (int z = 0; z < SIZE; ++z)
+            {
+                for (int x = 0; x < SIZE; ++x)
+                {
+                    const FaceKey key = keys[z][x];
+                    if (!key.present)
+                        continue;
+
+                    int x1 = x;
+                    while (x1 + 1 < SIZE && keys[z][x1 + 1] == key)
+                        ++x1;
+
+                    int z1 = z;
+                    for (bool grow = true; grow && z1 + 1 < SIZE;)
+                    {
+                        for (int i = x; i <= x1 && grow; ++i)
+                            grow = keys[z1 + 1][i] == key;
+                        if (grow)
+                            ++z1;
+                    }
+
+                    for (int j = z; j <= z1; ++j)
+                        for (int i = x; i <= x1; ++i)
+                            keys[j][i].present = false;
+
+                    emit(x, z, x1, z1, key);
+                }
+            }
+        }
+    }
+
+    void TerrainMesher::BuildAcre(const Town &town, int ax, int az, rendering::TerrainChunk &out,
+                                  MeshingStrategy strategy)
+    {
+        static const auto palette = TownPresenter::BuildPalette();
+
+        out.acreX = ax;
+        out.acreZ = az;
+        out.vertices.clear();
+        out.indices.clear();
+
+        const int x0 = ax * SIZE;
+        const int z0 = az * SIZE;
+        const bool greedy = strategy == MeshingStrategy::Greedy;
+
+        // Classify the acre's faces: tops, then one wall grid per direction
+        FaceKey tops[SIZE][SIZE];
+        FaceKey walls[4][SIZE][SIZE];
+        for (int lz = 0; lz < SIZE; ++lz)
+        {
+            const int wz = z0 + lz;
+            for (int lx = 0; lx < SIZE; ++lx)
+            {
+                const int wx = x0 + lx;
+                const Tile tile = town.TileAt(wx, wz);
+                const uint8_t color = TownPresenter::GetPaletteIndex(tile);
+                tops[lz][lx] = {0, tile.elevation, color, true};
+
+                // Off the map the cube keeps its own one-tile side, like the
+                // instanced cubes; inside, only the drop to the neighbour shows
+                for (int d = 0; d < 4; ++d)
+                {
+                    const utils::NeighborOffset &o = utils::NEIGHBORS_4[d];
+                    const int nx = wx + o.dx;
+                    const int nz = wz + o.dz;
+                    const int neighbor = utils::IsInBounds(nx, nz) ? town.ElevationRow(nz)[nx] : tile.elevation - 1;
+                    if (neighbor < tile.elevation)
+                        walls[d][lz][lx] = {static_cast<int8_t>(neighbor), tile.elevation, color, true};
+                }
+            }
+        }
+
+        auto top_y = [](int8_t elevation)
+        { return static_cast<float>(elevation) + HALF; };
+
+        if (!greedy)
+        {
+            for (int lz = 0; lz < SIZE; ++lz)
+            {
+                for (int lx = 0; lx < SIZE; ++lx)
+                {
+                    const FaceKey &top = tops[lz][lx];
+                    EmitTop(out, x0 + lx, z0 + lz, x0 + lx, z0 + lz, top_y(top.top), palette[top.palette]);
+
+                    for (int d = 0; d < 4; ++d)
+                    {
+                        const FaceKey &wall = walls[d][lz][lx];
+                        const utils::NeighborOffset &o = utils::NEIGHBORS_4[d];
+                        if (wall.present)
+                            EmitWall(out, x0 + lx, z0 + lz, 1, o.dx, o.dz, top_y(wall.bottom), top_y(wall.top), palette[wall.palette]);
+                    }
+                }
+            }
+            ComputeBounds(out);
+            return;
+        }
+
+        MergeRectangles(tops, [&](int lx0, int lz0, int lx1, int lz1, const FaceKey &key)
+                        { EmitTop(out, x0 + lx0, z0 + lz0, x0 + lx1, z0 + lz1, top_y(key.top), palette[key.palette]); });
+
+        // Walls are one tile deep, so each merges into runs along its face:
+        // x-facing walls run along z, z-facing walls along x
+        for (int d = 0; d < 4; ++d)
+        {
+            const utils::NeighborOffset &o = utils::NEIGHBORS_4[d];
+            const bool runs_along_z = o.dx != 0;
+            for (int line = 0; line < SIZE; ++line)
+            {
+                auto at = [&](int i) -> const FaceKey &
+                { return runs_along_z ? walls[d][i][line] : walls[d][line][i]; };
+
+                for (int start = 0; start < SIZE;)
+                {
+                    const FaceKey &key = at(start);
+                    int end = start + 1;
+                    while (end < SIZE && at(end) == key)
+                        ++end;
+
+                    if (key.present)
+                    {
+                        const int wx = x0 + (runs_along_z ? line : start);
+                        const int wz = z0 + (runs_along_z ? start : line);
+                        EmitWall(out, wx, wz, end - start, o.dx, o.dz, top_y(key.bottom), top_y(key.top), palette[key.palette]);
+                    }
+                    start = end;
+                }
+            }
+        }
+        ComputeBounds(out);
+    }
+
+    std::vector<rendering::TerrainChunk> TerrainMesher::BuildTown(const Town &town, MeshingStrategy strategy)
+    {
+        std::vector<rendering::TerrainChunk> chunks(Town::WIDTH * Town::HEIGHT);
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                BuildAcre(town, ax, az, chunks[Town::AcreIndex(ax, az)], strategy);
+        }
+        return chunks;
+    }
+
+    Town::AcreMask TerrainMesher::RebuildDirty(const Town &town, const Town::AcreMask &dirty,
+                                               std::vector<rendering::TerrainChunk> &chunks, MeshingStrategy strategy)
+    {
+        Town::AcreMask rebuilt;
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                bool affected = dirty.test(Town::AcreIndex(ax, az));
+                for (const utils::NeighborOffset &o : utils::NEIGHBORS_4)
+                {
+                    const int nx = ax + o.dx;
+                    const int nz = az + o.dz;
+                    if (nx >= 0 && nx < Town::WIDTH && nz >= 0 && nz < Town::HEIGHT)
+                        affected = affected || dirty.test(Town::AcreIndex(nx, nz));
+                }
+
+                if (affected)
+                {
+                    const int acre = Town::AcreIndex(ax, az);
+                    BuildAcre(town, ax, az, chunks[acre], strategy);
+                    rebuilt.set(acre);
+                }
+            }
+        }
+        return rebuilt;
+    }
+
+    TerrainMeshStats TerrainMesher::ComputeStats(const std::vector<rendering::TerrainChunk> &chunks)
+    {
+        TerrainMeshStats stats;
+        stats.chunks = chunks.size();
+        for (const rendering::TerrainChunk &chunk : chunks)
+        {
+            stats.quads += chunk.QuadCount();
+            stats.triangles += chunk.TriangleCount();
+            stats.vertices += chunk.vertices.size();
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include "world/Town.h"
+#include "rendering/TerrainMeshData.h"
+
+namespace cozy::world
+{
+    enum class MeshingStrategy
+    {
+        PerFace, // One quad per visible tile face
+        Greedy   // Merges coplanar, same-coloured faces into rectangles
+    };
+
+    struct TerrainMeshStats
+    {
+        size_t chunks = 0;
+        size_t quads = 0;
+        size_t triangles = 0;
+        size_t vertices = 0;
+    };
+
+    // Builds static per-acre terrain meshes containing only visible faces: every
+    // tile's top, plus the side walls that drop to a lower neighbour. Walls on
+    // acre borders are decided against the adjacent acre, so chunks stitch
+    // seamlessly. Pure CPU work; no graphics context is needed.
+    class TerrainMesher
+    {
+    public:
+        static void BuildAcre(const Town &town, int ax, int az, rendering::TerrainChunk &out,
+                              MeshingStrategy strategy = MeshingStrategy::Greedy);
+
+        // One chunk per acre, indexed by Town::AcreIndex
+        static std::vector<rendering::TerrainChunk> BuildTown(const Town &town,
+                                                              MeshingStrategy strategy = MeshingStrategy::Greedy);
+
+        // Rebuilds the chunks affected by the acres set in `dirty`: those acres
+        // plus their 4-neighbours, whose border walls depend on the changed
+        // tiles. `chunks` must come from BuildTown. Returns the rebuilt set.
+        static Town::AcreMask RebuildDirty(const Town &town, const Town::AcreMask &dirty,
+                                           std::vector<rendering::TerrainChunk> &chunks,
+                                           MeshingStrategy strategy = MeshingStrategy::Greedy);
+
+        static TerrainMeshStats ComputeStats(const std::vector<rendering::TerrainChunk> &chunks);
+    };
+}
@@ -0,0 +1,198 @@
+#include "TownImageExporter.h"
+#include "TownPresenter.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace cozy::world
+{
+    namespace
+    {
+        constexpr size_t PIXEL_BYTES = 3;
+        constexpr size_t ROW_BYTES = TownImageExporter::WIDTH * PIXEL_BYTES;
+
+        // TownPresenter's palette, converted to bytes once
+        const std::array<std::array<uint8_t, PIXEL_BYTES>, TownPresenter::PALETTE_SIZE> &BytePalette()
+        {
+            static const auto palette = []
+            {
+                std::array<std::array<uint8_t, PIXEL_BYTES>, TownPresenter::PALETTE_SIZE> bytes{};
+                const auto colours = TownPresenter::BuildPalette();
+                for (size_t i = 0; i < colours.size(); ++i)
+                {
+                    const float channels[PIXEL_BYTES] = {colours[i].x, colours[i].y, colours[i].z};
+                    for (size_t c = 0; c < PIXEL_BYTES; ++c)
+                        bytes[i][c] = static_cast<uint8_t>(std::lround(std::clamp(channels[c], 0.0f, 1.0f) * 255.0f));
+                }
+                return bytes;
+            }();
+            return palette;
+        }
+
+        void AppendBigEndian32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0)
+        {
+            static const auto table = []
+            {
+                std::array<uint32_t, 256> entries{};
+                for (uint32_t n = 0; n < 256; ++n)
+                {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; ++k)
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    entries[n] = c;
+                }
+                return entries;
+            }();
+
+            crc = ~crc;
+            for (size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        uint32_t Adler32(const uint8_t *data, size_t size)
+        {
+            // 5552 bytes is the most that can be summed before the 32-bit sums could overflow
+            uint32_t a = 1;
+            uint32_t b = 0;
+            while (size > 0)
+            {
+                const size_t block = std::min<size_t>(size, 5552);
+                for (size_t i = 0; i < block; ++i)
+                {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += block;
+                size -= block;
+            }
+            return (b << 16) | a;
+        }
+
+        // Length, type, data and CRC (over type and data)
+        void AppendChunk(std::vector<uint8_t> &out, const char type[4], const std::vector<uint8_t> &data)
+        {
+            AppendBigEndian32(out, static_cast<uint32_t>(data.size()));
+            const size_t type_offset = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            AppendBigEndian32(out, Crc32(out.data() + type_offset, out.size() - type_offset));
+        }
+
+        std::vector<uint8_t> EncodePpm(const std::vector<uint8_t> &pixels)
+        {
+            const std::string header = "P6\n" + std::to_string(TownImageExporter::WIDTH) + " " +
+                                       std::to_string(TownImageExporter::HEIGHT) + "\n255\n";
+            std::vector<uint8_t> out;
+            out.reserve(header.size() + pixels.size());
+            out.insert(out.end(), header.begin(), header.end());
+            out.insert(out.end(), pixels.begin(), pixels.end());
+            return out;
+        }
+
+        // The image is a few tens of kilobytes, so the zlib stream uses stored
+        // blocks: no compressor to carry, and still a valid PNG for any viewer
+        std::vector<uint8_t> EncodePng(const std::vector<uint8_t> &pixels)
+        {
+            constexpr uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+            constexpr size_t MAX_STORED_BLOCK = 65535;
+
+            // Each scanline is prefixed with filter type 0 (none)
+            std::vector<uint8_t> scanlines;
+            scanlines.reserve(TownImageExporter::HEIGHT * (ROW_BYTES + 1));
+            for (int z = 0; z < TownImageExporter::HEIGHT; ++z)
+            {
+                scanlines.push_back(0);
+                const auto row = pixels.begin() + static_cast<std::ptrdiff_t>(z * ROW_BYTES);
+                scanlines.insert(scanlines.end(), row, row + static_cast<std::ptrdiff_t>(ROW_BYTES));
+            }
+
+            std::vector<uint8_t> idat;
+            idat.reserve(scanlines.size() + scanlines.size() / MAX_STORED_BLOCK * 5 + 16);
+            idat.push_back(0x78); // Deflate, 32 KB window
+            idat.push_back(0x01); // No preset dictionary; (0x78 << 8 | 0x01) % 31 == 0
+            size_t offset = 0;
+            do
+            {
+                const size_t length = std::min(scanlines.size() - offset, MAX_STORED_BLOCK);
+                const bool final_block = offset + length == scanlines.size();
+                idat.push_back(final_block ? 1 : 0); // BFINAL, BTYPE = 00 (stored)
+                idat.push_back(static_cast<uint8_t>(length));
+                idat.push_back(static_cast<uint8_t>(length >> 8));
+                idat.push_back(static_cast<uint8_t>(~length));
+                idat.push_back(static_cast<uint8_t>(~length >> 8));
+                idat.insert(idat.end(), scanlines.begin() + static_cast<std::ptrdiff_t>(offset),
+                            scanlines.begin() + static_cast<std::ptrdiff_t>(offset + length));
+                offset += length;
+            } while (offset < scanlines.size());
+            AppendBigEndian32(idat, Adler32(scanlines.data(), scanlines.size()));
+
+            std::vector<uint8_t> ihdr;
+            AppendBigEndian32(ihdr, TownImageExporter::WIDTH);
+            AppendBigEndian32(ihdr, TownImageExporter::HEIGHT);
+            ihdr.push_back(8); // Bit depth
+            ihdr.push_back(2); // Colour type: RGB
+            ihdr.push_back(0); // Compression: deflate
+            ihdr.push_back(0); // Filter method 0
+            ihdr.push_back(0); // No interlace
+
+            std::vector<uint8_t> out(SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+            out.reserve(idat.size() + 64);
+            AppendChunk(out, "IHDR", ihdr);
+            AppendChunk(out, "IDAT", idat);
+            AppendChunk(out, "IEND", {});
+            return out;
+        }
+    }
+
+    std::vector<uint8_t> TownImageExporter::RenderPixels(const Town &town)
+    {
+        const auto &palette = BytePalette();
+        std::vector<uint8_t> pixels(static_cast<size_t>(HEIGHT) * ROW_BYTES);
+        uint8_t *out = pixels.data();
+        for (int z = 0; z < HEIGHT; ++z)
+        {
+            const TileType *types = town.TypeRow(z);
+            const int8_t *elevations = town.ElevationRow(z);
+            const uint8_t *autotiles = town.AutotileRow(z);
+            for (int x = 0; x < WIDTH; ++x)
+            {
+                const Tile tile{types[x], elevations[x], autotiles[x]};
+                const auto &colour = palette[TownPresenter::GetPaletteIndex(tile)];
+                out = std::copy(colour.begin(), colour.end(), out);
+            }
+        }
+        return pixels;
+    }
+
+    std::vector<uint8_t> TownImageExporter::Encode(const Town &town, ImageFormat format)
+    {
+        const std::vector<uint8_t> pixels = RenderPixels(town);
+        return format == ImageFormat::Png ? EncodePng(pixels) : EncodePpm(pixels);
+    }
+
+    void TownImageExporter::Write(const Town &town, const std::string &path)
+    {
+        const bool png = path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0;
+        const std::vector<uint8_t> bytes = Encode(town, png ? ImageFormat::Png : ImageFormat::Ppm);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open image file: " + path);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw std::runtime_error("Failed to write image file: " + path);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "world/Town.h"
+
+namespace cozy::world
+{
+    enum class ImageFormat
+    {
+        Ppm, // Binary P6
+        Png  // 8-bit RGB, stored (uncompressed) deflate blocks
+    };
+
+    // Top-down town images with one pixel per tile, coloured by the renderer's
+    // tile palette, for inspecting many seeds without a graphics context.
+    // Row 0 of the image is tile row z = 0.
+    class TownImageExporter
+    {
+    public:
+        static constexpr int WIDTH = Town::TILES_X;
+        static constexpr int HEIGHT = Town::TILES_Z;
+
+        // WIDTH * HEIGHT RGB8 pixels, row-major
+        static std::vector<uint8_t> RenderPixels(const Town &town);
+
+        static std::vector<uint8_t> Encode(const Town &town, ImageFormat format);
+
+        // ".png" paths are written as PNG, anything else as PPM. Throws
+        // std::runtime_error when the file can't be written.
+        static void Write(const Town &town, const std::string &path);
+    };
+}
@@ -1,6 +1,6 @@
 #include "TownPresenter.h"
-#include "world/generation/utils/WorldGenUtils.h"
-#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <string>
 
@@ -8,31 +8,131 @@ namespace cozy::world
 {
     std::vector<rendering::TileInstance> TownPresenter::GenerateRenderData(const Town &town)
     {
-        std::vector<rendering::TileInstance> instances;
-        instances.reserve(Town::WIDTH * Town::HEIGHT * Acre::SIZE * Acre::SIZE);
+        std::vector<rendering::TileInstance> instances(Town::TILE_COUNT);
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                WriteAcreInstances(town, ax, az, &instances[AcreInstanceOffset(Town::AcreIndex(ax, az))]);
+        }
+        return instances;
+    }
+
+    std::vector<rendering::InstanceBatch> TownPresenter::GenerateBatches(const Town &town)
+    {
+        std::vector<rendering::InstanceBatch> batches(Town::ACRE_COUNT);
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+                batches[Town::AcreIndex(ax, az)] = MakeAcreBatch(town, ax, az);
+        }
+        return batches;
+    }
+
+    void TownPresenter::UpdateBatches(const Town &town, const Town::AcreMask &acres,
+                                      std::vector<rendering::InstanceBatch> &batches)
+    {
+        for (int ax = 0; ax < Town::WIDTH; ++ax)
+        {
+            for (int az = 0; az < Town::HEIGHT; ++az)
+            {
+                const int acre = Town::AcreIndex(ax, az);
+                if (acres.test(acre))
+                    batches[acre] = MakeAcreBatch(town, ax, az);
+            }
+        }
+    }
+
+    rendering::InstanceBatch TownPresenter::MakeAcreBatch(const Town &town, int ax, int az)
+    {
+        const int x0 = ax * Acre::SIZE;
+        const int z0 = az * Acre::SIZE;
+        int min_elevation = town.ElevationRow(z0)[x0];
+        int max_elevation = min_elevation;
+        for (int wz = z0; wz < z0 + Acre::SIZE; ++wz)
+        {
+            const int8_t *row = town.ElevationRow(wz);
+            for (int wx = x0; wx < x0 + Acre::SIZE; ++wx)
+            {
+                min_elevation = std::min<int>(min_elevation, row[wx]);
+                max_elevation = std::max<int>(max_elevation, row[wx]);
+            }
+        }
+
+        // Cubes are centred on their tile and elevation with half-extent 0.5
+        rendering::InstanceBatch batch;
+        batch.first = static_cast<uint32_t>(AcreInstanceOffset(Town::AcreIndex(ax, az)));
+        batch.count = TILES_PER_ACRE;
+        const glm::vec3 half(0.5f);
+        batch.boundsMin = glm::vec3(static_cast<float>(x0), static_cast<float>(min_elevation), static_cast<float>(z0)) - half;
+        batch.boundsMax = glm::vec3(static_cast<float>(x0 + Acre::SIZE - 1), static_cast<float>(max_elevation),
+                                    static_cast<float>(z0 + Acre::SIZE - 1)) + half;
+        return batch;
+    }
 
+    void TownPresenter::UpdateRenderData(const Town &town, const Town::AcreMask &acres,
+                                         std::vector<rendering::TileInstance> &instances)
+    {
         for (int ax = 0; ax < Town::WIDTH; ++ax)
         {
             for (int az = 0; az < Town::HEIGHT; ++az)
             {
-                for (int lx = 0; lx < Acre::SIZE; ++lx)
+                const int acre = Town::AcreIndex(ax, az);
+                if (acres.test(acre))
+                    WriteAcreInstances(town, ax, az, &instances[AcreInstanceOffset(acre)]);
+            }
+        }
+    }
+
+    void TownPresenter::WriteAcreInstances(const Town &town, int ax, int az, rendering::TileInstance *out)
+    {
+        for (int lx = 0; lx < Acre::SIZE; ++lx)
+        {
+            for (int lz = 0; lz < Acre::SIZE; ++lz)
+            {
+                const Tile &tile = town.GetAcre(ax, az).tiles[lz][lx];
+
+                rendering::TileInstance &inst = *out++;
+                inst.x = static_cast<int16_t>(ax * Acre::SIZE + lx);
+                inst.z = static_cast<int16_t>(az * Acre::SIZE + lz);
+                inst.elevation = tile.elevation;
+                inst.type = static_cast<uint8_t>(tile.type);
+                inst.autotileIndex = tile.autotileIndex;
+                inst.paletteIndex = GetPaletteIndex(tile);
+            }
+        }
+    }
+
+    uint8_t TownPresenter::GetPaletteIndex(const Tile &tile)
+    {
+        // Only river/pond water distinguishes deep (autotile 46) from shoreline
+        // tiles; every other type maps to one entry, so equal colours share an
+        // index and merge in the greedy terrain mesher
+        const bool shaded_water = tile.type == TileType::RIVER || tile.type == TileType::POND ||
+                                  tile.type == TileType::RIVER_MOUTH;
+        const bool deep = shaded_water && tile.autotileIndex == 46;
+        const int elevation = std::clamp<int>(tile.elevation, 0, PALETTE_ELEVATIONS - 1);
+        const int type = static_cast<int>(tile.type);
+        return static_cast<uint8_t>((type * 2 + (deep ? 1 : 0)) * PALETTE_ELEVATIONS + elevation);
+    }
+
+    std::array<glm::vec3, TownPresenter::PALETTE_SIZE> TownPresenter::BuildPalette()
+    {
+        std::array<glm::vec3, PALETTE_SIZE> palette{};
+        for (int type = 0; type < PALETTE_TYPES; ++type)
+        {
+            for (int deep = 0; deep < 2; ++deep)
+            {
+                for (int elevation = 0; elevation < PALETTE_ELEVATIONS; ++elevation)
                 {
-                    for (int lz = 0; lz < Acre::SIZE; ++lz)
-                    {
-                        const Tile &tile = town.GetAcre(ax, az).tiles[lz][lx];
-
-                        rendering::TileInstance inst;
-                        float wx = static_cast<float>(ax * Acre::SIZE + lx);
-                        float wz = static_cast<float>(az * Acre::SIZE + lz);
-
-                        inst.modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(wx, (float)tile.elevation, wz));
-                        inst.color = GetTileColor(tile, tile.elevation);
-                        instances.push_back(inst);
-                    }
+                    Tile tile;
+                    tile.type = static_cast<TileType>(type);
+                    tile.elevation = static_cast<int8_t>(elevation);
+                    tile.autotileIndex = deep ? 46 : 0;
+                    palette[GetPaletteIndex(tile)] = GetTileColor(tile, elevation);
                 }
             }
         }
-        return instances;
+        return palette;
     }
 
     glm::vec3 TownPresenter::GetTileColor(const Tile &tile, int y)
@@ -76,133 +176,121 @@ namespace cozy::world
         }
     }
 
-    void TownPresenter::DebugDump(const Town &town)
+    namespace
+    {
+        char DumpSymbol(TileType type, int elevation)
+        {
+            switch (type)
+            {
+            case TileType::OCEAN:
+                return 'W';
+            case TileType::SAND:
+                return 's';
+            case TileType::RIVER_MOUTH:
+                return 'M';
+            case TileType::WATERFALL:
+                return 'V';
+            case TileType::RIVER:
+                return elevation == 2 ? 'R' : (elevation == 1 ? 'r' : '~');
+            case TileType::POND:
+                return elevation == 2 ? 'P' : (elevation == 1 ? 'p' : 'o');
+            case TileType::CLIFF:
+                return (elevation == 2) ? '#' : '=';
+            case TileType::RAMP:
+                return (elevation == 2) ? '/' : '\\';
+            case TileType::EMPTY:
+                return ' ';
+            default: // GRASS
+                return elevation == 2 ? '^' : (elevation == 1 ? ';' : '.');
+            }
+        }
+
+        void AppendBorder(std::string &out)
+        {
+            out += "  +";
+            out.append(Town::TILES_X + Town::WIDTH, '-');
+            out += "+\n";
+        }
+    }
+
+    std::string TownPresenter::FormatDebugDump(const Town &town)
     {
-        const int TOTAL_WIDTH = Town::WIDTH * Acre::SIZE;
-        const int TOTAL_HEIGHT = Town::HEIGHT * Acre::SIZE;
+        static constexpr const char *LEGEND =
+            "\nLegend:\n"
+            "  Terrain: . = Grass (L0)  ; = Grass (L1)  ^ = Grass (L2)\n"
+            "           s = Sand        W = Ocean\n"
+            "  Water:   ~ = River (L0)  r = River (L1)  R = River (L2)\n"
+            "           o = Pond (L0)   p = Pond (L1)   P = Pond (L2)\n"
+            "           M = Mouth       V = Waterfall\n"
+            "  Vertical: = = Mid Cliff  # = High Cliff  / \\ = Ramps\n\n";
 
-        std::cout << "\n--- Town Generation Debug Dump ---\n";
+        // Grid lines are "X | " + tiles + one space per acre + "|\n"; borders are
+        // one line per acre row plus the top; the rest is header and legend
+        const size_t line_bytes = 4 + Town::TILES_X + Town::WIDTH + 2;
+        std::string out;
+        out.reserve((Town::TILES_Z + Town::HEIGHT + 2) * line_bytes + 1024);
 
-        // 1. Column Headers (Acre 1, Acre 2, etc.)
-        std::cout << "     ";
+        out += "\n--- Town Generation Debug Dump ---\n";
+
+        // 1. Column headers (Acre 1, Acre 2, etc.), padded to the acre width plus separator
+        out += "     ";
         for (int ax = 0; ax < Town::WIDTH; ++ax)
         {
-            std::string label = "Acre " + std::to_string(ax + 1);
-            std::cout << label;
-            // Padding to align with Acre size (16 tiles + 1 space)
-            int label_spacing = Acre::SIZE + 1;
-            for (size_t i = label.length(); i < (size_t)label_spacing; ++i)
-                std::cout << " ";
+            char label[16];
+            const int length = std::snprintf(label, sizeof(label), "Acre %d", ax + 1);
+            out.append(label, static_cast<size_t>(length));
+            if (length < Acre::SIZE + 1)
+                out.append(static_cast<size_t>(Acre::SIZE + 1 - length), ' ');
         }
-        std::cout << "\n";
+        out += '\n';
 
-        // 2. Top Border
-        std::cout << "  +";
-        for (int i = 0; i < TOTAL_WIDTH + Town::WIDTH; ++i)
-            std::cout << "-";
-        std::cout << "+\n";
+        // 2. Top border
+        AppendBorder(out);
 
-        // 3. Grid Rendering
-        for (int z = 0; z < TOTAL_HEIGHT; ++z)
+        // 3. Grid, straight from the tile planes (the loops stay on the map, so
+        // no bounds checks are needed)
+        for (int z = 0; z < Town::TILES_Z; ++z)
         {
-            // Acre Row Labels (A, B, C...)
+            // Acre row labels (A, B, C...)
             if (z % Acre::SIZE == 0)
             {
-                char rowLetter = static_cast<char>('A' + (z / Acre::SIZE));
-                std::cout << rowLetter << " | ";
+                out += static_cast<char>('A' + (z / Acre::SIZE));
+                out += " | ";
             }
             else
             {
-                std::cout << "  | ";
+                out += "  | ";
             }
 
-            for (int x = 0; x < TOTAL_WIDTH; ++x)
+            const TileType *types = town.TypeRow(z);
+            const int8_t *elevations = town.ElevationRow(z);
+            for (int x = 0; x < Town::TILES_X; ++x)
             {
-                // Use refactored Utils for safe access
-                TileType type = utils::GetTileTypeSafe(town, x, z);
-                int elevation = utils::GetElevation(town, x, z);
-
-                char symbol;
-                switch (type)
-                {
-                case TileType::OCEAN:
-                    symbol = 'W';
-                    break;
-                case TileType::SAND:
-                    symbol = 's';
-                    break;
-                case TileType::RIVER_MOUTH:
-                    symbol = 'M';
-                    break;
-                case TileType::WATERFALL:
-                    symbol = 'V';
-                    break;
-                case TileType::RIVER:
-                    if (elevation == 2)
-                        symbol = 'R';
-                    else if (elevation == 1)
-                        symbol = 'r';
-                    else
-                        symbol = '~';
-                    break;
-                case TileType::POND:
-                    if (elevation == 2)
-                        symbol = 'P';
-                    else if (elevation == 1)
-                        symbol = 'p';
-                    else
-                        symbol = 'o';
-                    break;
-                case TileType::CLIFF:
-                    symbol = (elevation == 2) ? '#' : '=';
-                    break;
-                case TileType::RAMP:
-                    symbol = (elevation == 2) ? '/' : '\\';
-                    break;
-                case TileType::EMPTY:
-                    symbol = ' ';
-                    break;
-                default: // GRASS
-                    if (elevation == 2)
-                        symbol = '^';
-                    else if (elevation == 1)
-                        symbol = ';';
-                    else
-                        symbol = '.';
-                    break;
-                }
-
-                std::cout << symbol;
+                out += DumpSymbol(types[x], elevations[x]);
 
-                // Visual separator between Acres
+                // Visual separator between acres
                 if ((x + 1) % Acre::SIZE == 0)
-                    std::cout << " ";
+                    out += ' ';
             }
-            std::cout << "|\n";
+            out += "|\n";
 
-            // Acre Row Horizontal Separator
-            if ((z + 1) % Acre::SIZE == 0 && (z + 1) != TOTAL_HEIGHT)
-            {
-                std::cout << "  +";
-                for (int i = 0; i < TOTAL_WIDTH + Town::WIDTH; ++i)
-                    std::cout << "-";
-                std::cout << "+\n";
-            }
+            // Acre row horizontal separator
+            if ((z + 1) % Acre::SIZE == 0 && (z + 1) != Town::TILES_Z)
+                AppendBorder(out);
         }
 
-        // 4. Bottom Border
-        std::cout << "  +";
-        for (int i = 0; i < TOTAL_WIDTH + Town::WIDTH; ++i)
-            std::cout << "-";
-        std::cout << "+\n";
+        // 4. Bottom border
+        AppendBorder(out);
 
         // 5. Legend
-        std::cout << "\nLegend:\n"
-                  << "  Terrain: . = Grass (L0)  ; = Grass (L1)  ^ = Grass (L2)\n"
-                  << "           s = Sand        W = Ocean\n"
-                  << "  Water:   ~ = River (L0)  r = River (L1)  R = River (L2)\n"
-                  << "           o = Pond (L0)   p = Pond (L1)   P = Pond (L2)\n"
-                  << "           M = Mouth       V = Waterfall\n"
-                  << "  Vertical: = = Mid Cliff  # = High Cliff  / \\ = Ramps\n\n";
+        out += LEGEND;
+        return out;
+    }
+
+    void TownPresenter::DebugDump(const Town &town)
+    {
+        const std::string dump = FormatDebugDump(town);
+        std::cout.write(dump.data(), static_cast<std::streamsize>(dump.size()));
+        std::cout.flush();
     }
-}
\ No newline at end of file
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <string>
 #include <vector>
 #include "world/Town.h"
 #include "rendering/InstanceData.h"
@@ -11,10 +13,45 @@ namespace cozy::world
         // Generates the GPU instance data for rendering
         static std::vector<rendering::TileInstance> GenerateRenderData(const Town &town);
 
-        // Prints the ASCII map to the console
+        // Instances are acre-major: acre (ax, az) owns TILES_PER_ACRE consecutive
+        // instances starting at AcreInstanceOffset, so a dirty acre maps to one
+        // contiguous buffer range
+        static constexpr int TILES_PER_ACRE = Acre::SIZE * Acre::SIZE;
+        static constexpr size_t AcreInstanceOffset(int acre_index) { return static_cast<size_t>(acre_index) * TILES_PER_ACRE; }
+
+        // One batch per acre, indexed by Town::AcreIndex, bounding its cubes
+        static std::vector<rendering::InstanceBatch> GenerateBatches(const Town &town);
+
+        // Recomputes the bounds of the acres set in `acres`; `batches` must come
+        // from GenerateBatches
+        static void UpdateBatches(const Town &town, const Town::AcreMask &acres,
+                                  std::vector<rendering::InstanceBatch> &batches);
+
+        // Rewrites the instances of the acres set in `acres`; `instances` must
+        // come from GenerateRenderData
+        static void UpdateRenderData(const Town &town, const Town::AcreMask &acres,
+                                     std::vector<rendering::TileInstance> &instances);
+
+        // Tile colours are indexed by (type, deep water, elevation); instances
+        // carry the index and the shader reads the colour from this table.
+        // The Engine injects PALETTE_SIZE into instanced.vert as a #define.
+        static constexpr int PALETTE_ELEVATIONS = 4;
+        static constexpr int PALETTE_TYPES = static_cast<int>(TileType::RAMP) + 1;
+        static constexpr int PALETTE_SIZE = PALETTE_TYPES * 2 * PALETTE_ELEVATIONS;
+
+        static std::array<glm::vec3, PALETTE_SIZE> BuildPalette();
+        static uint8_t GetPaletteIndex(const Tile &tile);
+
+        // ASCII map of the town with acre labels and a legend, built in one
+        // preallocated string
+        static std::string FormatDebugDump(const Town &town);
+
+        // Prints FormatDebugDump to the console in a single write
         static void DebugDump(const Town &town);
 
     private:
+        static void WriteAcreInstances(const Town &town, int ax, int az, rendering::TileInstance *out);
+        static rendering::InstanceBatch MakeAcreBatch(const Town &town, int ax, int az);
         static glm::vec3 GetTileColor(const Tile &tile, int y);
     };
 }
\ No newline at end of file
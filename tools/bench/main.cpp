@@ -0,0 +1,365 @@
+// Microbenchmarks for world generation.
+// Times each generation step, the hot utilities, a full Town::Generate and
+// render-data building over a fixed seed corpus, then prints per-benchmark
+// latency percentiles as JSON. Run it before and after a performance change
+// with the same arguments and compare the medians.
+//
+// Usage: cozy_bench [--start <seed>] [--seeds <n>] [--repeat <n>] [--filter <text>]
+//                   [--mode legacy|substreams] [--out <file.json>]
+
+#include "world/Town.h"
+#include "world/data/TownConfig.h"
+#include "world/generation/instrumentation/AllocationTracker.h"
+#include "world/generation/utils/AutoTileUtils.h"
+#include "world/generation/utils/WorldGenUtils.h"
+#include "world/presentation/TownPresenter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace cozy::world;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        uint64_t startSeed = 0;
+        uint64_t seeds = 64;
+        unsigned repeat = 5; // Timed runs per seed
+        std::string filter;  // Only benchmarks whose name contains this
+        std::string outPath; // stdout when empty
+        GenerationMode mode = GenerationMode::LegacyV1;
+    };
+
+    // Keeps benchmarked results observable so the optimizer can't drop the work
+    volatile uint64_t g_sink = 0;
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: cozy_bench [--start <seed>] [--seeds <n>] [--repeat <n>] [--filter <text>]\n"
+                  << "                  [--mode legacy|substreams] [--out <file.json>]\n";
+    }
+
+    // std::stoull skips whitespace and accepts a sign, wrapping "-5" to a huge
+    // count, so only plain digits get through
+    uint64_t ParseUnsigned(const std::string &arg, const std::string &value)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+            throw std::runtime_error(arg + " expects a non-negative integer, got '" + value + "'");
+        try
+        {
+            return std::stoull(value);
+        }
+        catch (const std::out_of_range &)
+        {
+            throw std::runtime_error(arg + " is out of range: " + value);
+        }
+    }
+
+    bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char *
+            {
+                if (i + 1 >= argc)
+                    throw std::runtime_error("Missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--start")
+                options.startSeed = ParseUnsigned(arg, next());
+            else if (arg == "--seeds")
+                options.seeds = ParseUnsigned(arg, next());
+            else if (arg == "--repeat")
+                options.repeat = static_cast<unsigned>(ParseUnsigned(arg, next()));
+            else if (arg == "--filter")
+                options.filter = next();
+            else if (arg == "--out")
+                options.outPath = next();
+            else if (arg == "--mode")
+            {
+                const std::string mode = next();
+                if (mode == "legacy")
+                    options.mode = GenerationMode::LegacyV1;
+                else if (mode == "substreams")
+                    options.mode = GenerationMode::SubstreamsV2;
+                else
+                    throw std::runtime_error("Unknown generation mode: " + mode);
+            }
+            else if (arg == "--help" || arg == "-h")
+                return false;
+            else
+                throw std::runtime_error("Unknown argument: " + arg);
+        }
+
+        if (options.seeds == 0 || options.repeat == 0)
+            throw std::runtime_error("--seeds and --repeat must be at least 1");
+        return true;
+    }
+
+    // Latency samples of one benchmark, in nanoseconds. itemsPerSample is the
+    // number of calls a sample covers (1 for whole-town benchmarks), so
+    // per-call costs of the small utilities can be read off the JSON.
+    struct Benchmark
+    {
+        std::vector<double> samplesNs;
+        uint64_t itemsPerSample = 1;
+    };
+
+    class Suite
+    {
+    public:
+        explicit Suite(std::string filter) : m_filter(std::move(filter)) {}
+
+        bool Enabled(const std::string &name) const
+        {
+            return m_filter.empty() || name.find(m_filter) != std::string::npos;
+        }
+
+        void Record(const std::string &name, double ns, uint64_t items = 1)
+        {
+            Benchmark &bench = m_benchmarks[name];
+            bench.samplesNs.push_back(ns);
+            bench.itemsPerSample = items;
+        }
+
+        // Times fn() once and records it under `name` (when enabled)
+        template <typename Fn>
+        void Time(const std::string &name, uint64_t items, Fn &&fn)
+        {
+            if (!Enabled(name))
+                return;
+            const auto start = Clock::now();
+            fn();
+            const auto stop = Clock::now();
+            Record(name, std::chrono::duration<double, std::nano>(stop - start).count(), items);
+        }
+
+        const std::map<std::string, Benchmark> &Results() const { return m_benchmarks; }
+
+    private:
+        std::string m_filter;
+        std::map<std::string, Benchmark> m_benchmarks; // Sorted by name, so reports diff cleanly
+    };
+
+    // Nearest-rank percentile of sorted samples
+    double Percentile(const std::vector<double> &sorted, double p)
+    {
+        const size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    void BenchGenerate(Suite &suite, Town &town, uint64_t seed, const TownConfig &config)
+    {
+        const bool wholeTown = suite.Enabled("Town::Generate");
+        bool anyStep = false;
+        for (const char *step : {"ocean", "cliffs", "rivers", "ramps", "ponds"})
+            anyStep = anyStep || suite.Enabled(std::string(step) + "::Execute");
+        if (!wholeTown && !anyStep)
+            return;
+
+        // The default ReportLevel::Timing: step durations are all this reads,
+        // and the whole-town time shouldn't include Full's diffing and hashing
+        const auto start = Clock::now();
+        town.Generate(seed, config);
+        const auto stop = Clock::now();
+        if (wholeTown)
+            suite.Record("Town::Generate", std::chrono::duration<double, std::nano>(stop - start).count());
+
+        // The pipeline already times each step around its call alone; every
+        // step is a <name>::Execute function
+        for (const StepStats &step : town.GetLastReport().steps)
+        {
+            const std::string name = step.name + "::Execute";
+            if (suite.Enabled(name))
+                suite.Record(name, step.durationMs * 1.0e6);
+        }
+    }
+
+    void BenchUtilities(Suite &suite, Town &town, uint64_t seed, const TownConfig &config)
+    {
+        const int noiseSeed = static_cast<int>(seed);
+        const float scale = config.pondNoiseScale;
+
+        suite.Time("TownPresenter::GenerateRenderData", 1, [&]
+                   { g_sink = g_sink + TownPresenter::GenerateRenderData(town).size(); });
+
+        // One sample per call site pattern: a full grid of scalar samples, and
+        // the same grid a row at a time through the vector kernels
+        suite.Time("utils::SmoothNoise", Town::TILE_COUNT, [&]
+                   {
+                       float sum = 0.0f;
+                       for (int wz = 0; wz < Town::TILES_Z; ++wz)
+                       {
+                           for (int wx = 0; wx < Town::TILES_X; ++wx)
+                               sum += utils::SmoothNoise(wx * scale, wz * scale, noiseSeed);
+                       }
+                       g_sink = g_sink + static_cast<uint64_t>(static_cast<int64_t>(sum)); });
+
+        suite.Time("utils::SmoothNoiseRow", Town::TILE_COUNT, [&]
+                   {
+                       float row[Town::TILES_X];
+                       float sum = 0.0f;
+                       for (int wz = 0; wz < Town::TILES_Z; ++wz)
+                       {
+                           utils::SmoothNoiseRow(0, wz, Town::TILES_X, scale, noiseSeed, row);
+                           sum += row[Town::TILES_X - 1];
+                       }
+                       g_sink = g_sink + static_cast<uint64_t>(static_cast<int64_t>(sum)); });
+
+        // The same samples as scattered points, with the coordinates laid out
+        // before timing starts
+        std::vector<float> xs(Town::TILE_COUNT);
+        std::vector<float> zs(Town::TILE_COUNT);
+        std::vector<float> out(Town::TILE_COUNT);
+        for (int i = 0; i < Town::TILE_COUNT; ++i)
+        {
+            xs[i] = (i % Town::TILES_X) * scale;
+            zs[i] = (i / Town::TILES_X) * scale;
+        }
+        suite.Time("utils::SmoothNoiseBatch", Town::TILE_COUNT, [&]
+                   {
+                       utils::SmoothNoiseBatch(xs.data(), zs.data(), Town::TILE_COUNT, noiseSeed, out.data());
+                       g_sink = g_sink + static_cast<uint64_t>(static_cast<int64_t>(out[Town::TILE_COUNT - 1])); });
+
+        // Water connectivity over the whole map, as the river and pond autotilers use it
+        suite.Time("utils::Calculate8BitMask", Town::TILE_COUNT, [&]
+                   {
+                       const auto &water = town.Masks().Get(TerrainClass::Water);
+                       auto connects = [&](int nx, int nz)
+                       { return water.Test(nx, nz); };
+                       uint64_t sum = 0;
+                       for (int wz = 0; wz < Town::TILES_Z; ++wz)
+                       {
+                           for (int wx = 0; wx < Town::TILES_X; ++wx)
+                               sum += utils::Calculate8BitMask(wx, wz, connects);
+                       }
+                       g_sink = g_sink + sum; });
+
+        // Includes a one-tile ring off the map, so the out-of-bounds path is timed too
+        constexpr uint64_t ringTiles = static_cast<uint64_t>(Town::TILES_X + 2) * (Town::TILES_Z + 2);
+        suite.Time("utils::GetTileSafe", ringTiles, [&]
+                   {
+                       uint64_t sum = 0;
+                       for (int wz = -1; wz <= Town::TILES_Z; ++wz)
+                       {
+                           for (int wx = -1; wx <= Town::TILES_X; ++wx)
+                           {
+                               if (auto tile = utils::GetTileSafe(town, wx, wz))
+                                   sum += static_cast<uint64_t>(static_cast<int8_t>(tile->elevation)) + 1;
+                           }
+                       }
+                       g_sink = g_sink + sum; });
+    }
+
+    void WriteReport(std::ostream &out, const Options &options, const Suite &suite)
+    {
+        out << "{\"start_seed\":" << options.startSeed
+            << ",\"seeds\":" << options.seeds
+            << ",\"repeat\":" << options.repeat
+            << ",\"mode\":\"" << (options.mode == GenerationMode::SubstreamsV2 ? "substreams" : "legacy") << '"'
+            << ",\"allocation_tracking\":" << (instrumentation::IsAllocationTrackingEnabled() ? "true" : "false")
+            << ",\"benchmarks\":[";
+
+        bool first = true;
+        for (const auto &[name, bench] : suite.Results())
+        {
+            std::vector<double> sorted = bench.samplesNs;
+            std::sort(sorted.begin(), sorted.end());
+            double total = 0.0;
+            for (double ns : sorted)
+                total += ns;
+            const double median = Percentile(sorted, 50.0);
+
+            if (!first)
+                out << ',';
+            first = false;
+            out << "\n  {\"name\":\"" << name << '"'
+                << ",\"samples\":" << sorted.size()
+                << ",\"items_per_sample\":" << bench.itemsPerSample
+                << ",\"min_us\":" << sorted.front() / 1000.0
+                << ",\"median_us\":" << median / 1000.0
+                << ",\"p90_us\":" << Percentile(sorted, 90.0) / 1000.0
+                << ",\"p99_us\":" << Percentile(sorted, 99.0) / 1000.0
+                << ",\"max_us\":" << sorted.back() / 1000.0
+                << ",\"mean_us\":" << total / static_cast<double>(sorted.size()) / 1000.0
+                << ",\"median_ns_per_item\":" << median / static_cast<double>(bench.itemsPerSample) << '}';
+        }
+        out << "\n]}\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        Options options;
+        if (!ParseOptions(argc, argv, options))
+        {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+
+        TownConfig config;
+        config.generationMode = options.mode;
+
+        auto town = std::make_unique<Town>();
+        Suite suite(options.filter);
+
+        // Untimed warm-up: first-touch page faults and lazily built tables
+        town->Generate(options.startSeed, config);
+        g_sink = g_sink + TownPresenter::GenerateRenderData(*town).size();
+
+        if (instrumentation::IsAllocationTrackingEnabled())
+            std::cerr << "[cozy_bench] Allocation tracking is compiled in; compare only against baselines built the same way"
+                      << std::endl;
+
+        for (uint64_t i = 0; i < options.seeds; ++i)
+        {
+            const uint64_t seed = options.startSeed + i;
+            for (unsigned r = 0; r < options.repeat; ++r)
+                BenchGenerate(suite, *town, seed, config);
+
+            // Utilities run on this seed's finished town
+            town->Generate(seed, config);
+            for (unsigned r = 0; r < options.repeat; ++r)
+                BenchUtilities(suite, *town, seed, config);
+        }
+
+        if (suite.Results().empty())
+            throw std::runtime_error("No benchmark matches filter: " + options.filter);
+
+        if (options.outPath.empty())
+        {
+            WriteReport(std::cout, options, suite);
+        }
+        else
+        {
+            std::ofstream out(options.outPath);
+            if (!out.is_open())
+                throw std::runtime_error("Failed to open output file: " + options.outPath);
+            WriteReport(out, options, suite);
+            std::cout << "[cozy_bench] Report written to " << options.outPath << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[FATAL ERROR]: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
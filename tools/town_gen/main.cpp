@@ -0,0 +1,456 @@
+// Headless batch town generator.
+// Generates towns for a contiguous seed range across all hardware threads without
+// touching GLFW or OpenGL, then reports throughput and per-seed summaries.
+//
+// Usage: cozy_town_gen [--start <seed>] [--count <n>] [--threads <n>] [--out <file.csv>]
+//                      [--report <file.json>] [--mode legacy|substreams] [--snapshots <dir>]
+//                      [--archive <file.czta>] [--images <dir>] [--image-format png|ppm]
+
+#include "world/Town.h"
+#include "world/data/TownConfig.h"
+#include "world/generation/instrumentation/AllocationTracker.h"
+#include "world/generation/utils/WorldGenUtils.h"
+#include "world/io/TownArchive.h"
+#include "world/io/TownSnapshot.h"
+#include "world/presentation/TownImageExporter.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace cozy::world;
+
+    struct Options
+    {
+        uint64_t startSeed = 0;
+        uint64_t count = 1000;
+        unsigned threads = 0; // 0 = hardware concurrency
+        std::string outPath;
+        std::string reportPath;
+        std::string snapshotDir; // One <seed>.cztn snapshot per town when set
+        std::string archivePath; // Every town in one compressed archive when set
+        std::string imageDir;    // One <seed>.png/.ppm top-down image per town when set
+        std::string imageExtension = ".png";
+        GenerationMode mode = GenerationMode::LegacyV1;
+    };
+
+    struct SeedResult
+    {
+        uint64_t seed = 0;
+        double generationMs = 0.0;
+        std::array<uint32_t, static_cast<size_t>(TileType::RAMP) + 1> typeCounts{};
+        int maxElevation = 0;
+    };
+
+    // Per-step totals across every town a worker generated
+    struct StepAggregate
+    {
+        std::string name;
+        uint64_t samples = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t tilesMutated = 0;
+    };
+
+    using StepAggregates = std::vector<StepAggregate>;
+
+    // Number of seeds a worker claims at once; keeps the shared counter cold.
+    constexpr uint64_t SEED_CHUNK = 64;
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: cozy_town_gen [--start <seed>] [--count <n>] [--threads <n>] [--out <file.csv>]\n"
+                  << "                     [--report <file.json>] [--mode legacy|substreams] [--snapshots <dir>]\n"
+                  << "                     [--archive <file.czta>] [--images <dir>] [--image-format png|ppm]\n";
+    }
+
+    void Accumulate(StepAggregates &aggregates, const GenerationReport &report)
+    {
+        if (aggregates.size() < report.steps.size())
+            aggregates.resize(report.steps.size());
+
+        for (size_t i = 0; i < report.steps.size(); ++i)
+        {
+            const StepStats &step = report.steps[i];
+            StepAggregate &agg = aggregates[i];
+            agg.name = step.name;
+            agg.samples++;
+            agg.totalMs += step.durationMs;
+            agg.maxMs = std::max(agg.maxMs, step.durationMs);
+            agg.allocations += step.allocations;
+            agg.allocatedBytes += step.allocatedBytes;
+            agg.tilesMutated += step.tilesMutated;
+        }
+    }
+
+    void Merge(StepAggregates &into, const StepAggregates &from)
+    {
+        if (into.size() < from.size())
+            into.resize(from.size());
+
+        for (size_t i = 0; i < from.size(); ++i)
+        {
+            StepAggregate &agg = into[i];
+            agg.name = from[i].name;
+            agg.samples += from[i].samples;
+            agg.totalMs += from[i].totalMs;
+            agg.maxMs = std::max(agg.maxMs, from[i].maxMs);
+            agg.allocations += from[i].allocations;
+            agg.allocatedBytes += from[i].allocatedBytes;
+            agg.tilesMutated += from[i].tilesMutated;
+        }
+    }
+
+    // std::stoull skips whitespace and accepts a sign, wrapping "-5" to a huge
+    // count, so only plain digits get through
+    uint64_t ParseUnsigned(const std::string &arg, const std::string &value)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+            throw std::runtime_error(arg + " expects a non-negative integer, got '" + value + "'");
+        try
+        {
+            return std::stoull(value);
+        }
+        catch (const std::out_of_range &)
+        {
+            throw std::runtime_error(arg + " is out of range: " + value);
+        }
+    }
+
+    bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char *
+            {
+                if (i + 1 >= argc)
+                    throw std::runtime_error("Missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--start")
+                options.startSeed = ParseUnsigned(arg, next());
+            else if (arg == "--count")
+                options.count = ParseUnsigned(arg, next());
+            else if (arg == "--threads")
+                options.threads = static_cast<unsigned>(ParseUnsigned(arg, next()));
+            else if (arg == "--out")
+                options.outPath = next();
+            else if (arg == "--report")
+                options.reportPath = next();
+            else if (arg == "--snapshots")
+                options.snapshotDir = next();
+            else if (arg == "--archive")
+                options.archivePath = next();
+            else if (arg == "--images")
+                options.imageDir = next();
+            else if (arg == "--image-format")
+            {
+                const std::string format = next();
+                if (format != "png" && format != "ppm")
+                    throw std::runtime_error("Unknown image format: " + format);
+                options.imageExtension = "." + format;
+            }
+            else if (arg == "--mode")
+            {
+                const std::string mode = next();
+                if (mode == "legacy")
+                    options.mode = GenerationMode::LegacyV1;
+                else if (mode == "substreams")
+                    options.mode = GenerationMode::SubstreamsV2;
+                else
+                    throw std::runtime_error("Unknown generation mode: " + mode);
+            }
+            else if (arg == "--help" || arg == "-h")
+                return false;
+            else
+                throw std::runtime_error("Unknown argument: " + arg);
+        }
+
+        if (options.count == 0)
+            throw std::runtime_error("--count must be at least 1");
+        return true;
+    }
+
+    void Summarize(const Town &town, SeedResult &result)
+    {
+        for (int z = 0; z < utils::GetWorldHeight(); ++z)
+        {
+            for (int x = 0; x < utils::GetWorldWidth(); ++x)
+            {
+                result.typeCounts[static_cast<size_t>(utils::GetTileTypeSafe(town, x, z))]++;
+                result.maxElevation = std::max(result.maxElevation, utils::GetElevation(town, x, z));
+            }
+        }
+    }
+
+    // Shared by all workers. Towns are added in seed order whatever order
+    // they finish in, so the archive bytes don't depend on thread scheduling:
+    // a town that finishes early waits here as snapshot bytes until every
+    // earlier seed is in. Workers claim seeds in ascending chunks, so at most
+    // about one chunk per thread is ever parked.
+    struct ArchiveSink
+    {
+        std::unique_ptr<io::TownArchiveWriter> writer;
+        std::mutex mutex;
+        uint64_t nextIndex = 0;                           // Seed index the archive takes next
+        std::map<uint64_t, std::vector<uint8_t>> parked; // Seed index -> SerializeTown bytes
+    };
+
+    // Call with the sink's mutex held. Exceptions must not escape a worker
+    // thread, so errors are reported and the town is skipped.
+    template <typename Source>
+    void AddNext(ArchiveSink &archive, const Source &source)
+    {
+        try
+        {
+            archive.writer->Add(source);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[cozy_town_gen] " << e.what() << std::endl;
+        }
+        ++archive.nextIndex;
+    }
+
+    void SubmitToArchive(ArchiveSink &archive, uint64_t index, const Town &town)
+    {
+        std::unique_lock<std::mutex> lock(archive.mutex);
+        if (index == archive.nextIndex)
+        {
+            AddNext(archive, town);
+        }
+        else
+        {
+            // Serialize without holding the lock; only this thread can add `index`
+            lock.unlock();
+            std::vector<uint8_t> snapshot = io::SerializeTown(town, false);
+            lock.lock();
+            archive.parked.emplace(index, std::move(snapshot));
+        }
+
+        while (!archive.parked.empty() && archive.parked.begin()->first == archive.nextIndex)
+        {
+            const std::vector<uint8_t> &snapshot = archive.parked.begin()->second;
+            AddNext(archive, io::TownSnapshotView::FromMemory(snapshot.data(), snapshot.size(), false));
+            archive.parked.erase(archive.parked.begin());
+        }
+    }
+
+    void Worker(const Options &options, const TownConfig &config,
+                std::atomic<uint64_t> &nextIndex, std::vector<SeedResult> &results,
+                StepAggregates &stepTotals, ArchiveSink &archive)
+    {
+        // Each worker owns its Town; Town::Generate builds a fresh pipeline per call.
+        auto town = std::make_unique<Town>();
+        // Mutation counts are only needed for the step report
+        const ReportLevel level = options.reportPath.empty() ? ReportLevel::Timing : ReportLevel::Full;
+
+        for (;;)
+        {
+            uint64_t begin = nextIndex.fetch_add(SEED_CHUNK, std::memory_order_relaxed);
+            if (begin >= options.count)
+                break;
+            uint64_t end = std::min(begin + SEED_CHUNK, options.count);
+
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                SeedResult result;
+                result.seed = options.startSeed + i;
+
+                auto start = std::chrono::steady_clock::now();
+                town->Generate(result.seed, config, level);
+                auto stop = std::chrono::steady_clock::now();
+
+                result.generationMs = std::chrono::duration<double, std::milli>(stop - start).count();
+                Accumulate(stepTotals, town->GetLastReport());
+
+                // Per-seed rows are only kept for --out
+                if (!results.empty())
+                {
+                    Summarize(*town, result);
+                    results[i] = result;
+                }
+
+                if (!options.snapshotDir.empty())
+                {
+                    // Exceptions must not escape a worker thread
+                    try
+                    {
+                        io::WriteTownSnapshot(*town, options.snapshotDir + "/" + std::to_string(result.seed) + ".cztn");
+                    }
+                    catch (const std::exception &e)
+                    {
+                        std::cerr << "[cozy_town_gen] " << e.what() << std::endl;
+                    }
+                }
+
+                if (!options.imageDir.empty())
+                {
+                    try
+                    {
+                        TownImageExporter::Write(*town, options.imageDir + "/" + std::to_string(result.seed) +
+                                                            options.imageExtension);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        std::cerr << "[cozy_town_gen] " << e.what() << std::endl;
+                    }
+                }
+
+                if (archive.writer)
+                    SubmitToArchive(archive, i, *town);
+            }
+        }
+    }
+
+    void WriteResults(const std::string &path, const std::vector<SeedResult> &results)
+    {
+        std::ofstream out(path);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open output file: " + path);
+
+        out << "seed,generation_ms,max_elevation,grass,sand,river,waterfall,pond,ocean,river_mouth,cliff,ramp\n";
+        for (const auto &r : results)
+        {
+            auto count = [&](TileType type)
+            { return r.typeCounts[static_cast<size_t>(type)]; };
+
+            out << r.seed << ',' << r.generationMs << ',' << r.maxElevation << ','
+                << count(TileType::GRASS) << ',' << count(TileType::SAND) << ','
+                << count(TileType::RIVER) << ',' << count(TileType::WATERFALL) << ','
+                << count(TileType::POND) << ',' << count(TileType::OCEAN) << ','
+                << count(TileType::RIVER_MOUTH) << ',' << count(TileType::CLIFF) << ','
+                << count(TileType::RAMP) << '\n';
+        }
+    }
+
+    void WriteStepReport(const std::string &path, const StepAggregates &steps, uint64_t towns, double seconds)
+    {
+        std::ofstream out(path);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open report file: " + path);
+
+        out << "{\"towns\":" << towns
+            << ",\"wall_seconds\":" << seconds
+            << ",\"allocation_tracking\":" << (instrumentation::IsAllocationTrackingEnabled() ? "true" : "false")
+            << ",\"steps\":[";
+
+        for (size_t i = 0; i < steps.size(); ++i)
+        {
+            const StepAggregate &s = steps[i];
+            double n = s.samples ? static_cast<double>(s.samples) : 1.0;
+            if (i > 0)
+                out << ',';
+            out << "{\"name\":\"" << s.name << '"'
+                << ",\"total_ms\":" << s.totalMs
+                << ",\"mean_ms\":" << s.totalMs / n
+                << ",\"max_ms\":" << s.maxMs
+                << ",\"mean_allocations\":" << static_cast<double>(s.allocations) / n
+                << ",\"mean_allocated_bytes\":" << static_cast<double>(s.allocatedBytes) / n
+                << ",\"mean_tiles_mutated\":" << static_cast<double>(s.tilesMutated) / n << '}';
+        }
+        out << "]}\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        Options options;
+        if (!ParseOptions(argc, argv, options))
+        {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+
+        unsigned threadCount = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        threadCount = static_cast<unsigned>(std::min<uint64_t>(threadCount, std::max<uint64_t>(1, options.count)));
+
+        TownConfig config;
+        config.generationMode = options.mode;
+        if (!options.snapshotDir.empty())
+            std::filesystem::create_directories(options.snapshotDir);
+        if (!options.imageDir.empty())
+            std::filesystem::create_directories(options.imageDir);
+
+        ArchiveSink archive;
+        if (!options.archivePath.empty())
+            archive.writer = std::make_unique<io::TownArchiveWriter>(options.archivePath);
+        std::vector<SeedResult> results(options.outPath.empty() ? 0 : options.count);
+        std::atomic<uint64_t> nextIndex{0};
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<StepAggregates> workerSteps(threadCount);
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (unsigned t = 0; t < threadCount; ++t)
+            workers.emplace_back(Worker, std::cref(options), std::cref(config), std::ref(nextIndex),
+                                 std::ref(results), std::ref(workerSteps[t]), std::ref(archive));
+        for (auto &worker : workers)
+            worker.join();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double throughput = seconds > 0.0 ? static_cast<double>(options.count) / seconds : 0.0;
+
+        std::cout << "[cozy_town_gen] Generated " << options.count << " towns (seeds "
+                  << options.startSeed << ".." << options.startSeed + options.count - 1 << ") in "
+                  << seconds << " s using " << threadCount << " threads: "
+                  << throughput << " towns/sec" << std::endl;
+
+        if (!options.outPath.empty())
+        {
+            WriteResults(options.outPath, results);
+            std::cout << "[cozy_town_gen] Per-seed results written to " << options.outPath << std::endl;
+        }
+
+        if (!options.snapshotDir.empty())
+            std::cout << "[cozy_town_gen] Snapshots written to " << options.snapshotDir << std::endl;
+        if (!options.imageDir.empty())
+            std::cout << "[cozy_town_gen] Images written to " << options.imageDir << std::endl;
+
+        if (archive.writer)
+        {
+            archive.writer->Finish();
+            std::cout << "[cozy_town_gen] Archive of " << archive.writer->TownCount() << " towns ("
+                      << archive.writer->BytesWritten() << " bytes) written to " << options.archivePath << std::endl;
+        }
+
+        if (!options.reportPath.empty())
+        {
+            StepAggregates stepTotals;
+            for (const auto &steps : workerSteps)
+                Merge(stepTotals, steps);
+            WriteStepReport(options.reportPath, stepTotals, options.count, seconds);
+            std::cout << "[cozy_town_gen] Step report written to " << options.reportPath << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[FATAL ERROR]: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
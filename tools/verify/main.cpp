@@ -0,0 +1,607 @@
+// Determinism regression check for town generation.
+// Regenerates every seed in a checked-in golden table and compares the tile
+// plane hash after each pipeline step (GenerationPipeline's per-step
+// layersHash) against the recorded one. A mismatch names the first step whose
+// output changed and, from the per-acre digests the table also stores for
+// every step, the first acre that step left different. For the first
+// REFERENCE_SEEDS seeds of the corpus the tree also holds the tile planes
+// after every step (one archive per step), so for those seeds it names the
+// first tile the divergent step left different.
+//
+// Usage: cozy_verify [--golden <file>] [--mode legacy|substreams] [--reference <dir>]
+//        cozy_verify --record [--golden <file>] [--mode legacy|substreams] [--start <seed>]
+//                    [--count <n>] [--reference <dir>]
+//
+// Without --golden and --reference the table and reference directory for
+// --mode in the source tree are used. Re-record only when an output change is
+// intended, and say so in the commit. Verifying also checks the batched noise
+// kernels against the scalar SmoothNoise, bit for bit.
+
+#include "world/Town.h"
+#include "world/data/TownConfig.h"
+#include "world/generation/utils/WorldGenUtils.h"
+#include "world/io/TownArchive.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef COZY_GOLDEN_DIR
+#define COZY_GOLDEN_DIR "tools/verify"
+#endif
+
+namespace
+{
+    using namespace cozy::world;
+
+    constexpr const char *TABLE_MAGIC = "cozy-golden";
+    constexpr int TABLE_VERSION = 2; // 2: per-step acre digests
+
+    // Divergent seeds printed in full; the rest are only counted
+    constexpr size_t MAX_REPORTED_SEEDS = 10;
+
+    // Leading seeds whose per-step tile planes are recorded as reference
+    // archives; enough to name the tile for the seeds a regression reports
+    // first without bloating the tree
+    constexpr uint64_t REFERENCE_SEEDS = 32;
+
+    struct Options
+    {
+        bool record = false;
+        std::string goldenPath;    // Default: golden_<mode>.txt in COZY_GOLDEN_DIR
+        std::string referenceDir;  // Default: reference_<mode> in COZY_GOLDEN_DIR
+        uint64_t startSeed = 0;
+        uint64_t count = 2000;
+        GenerationMode mode = GenerationMode::LegacyV1;
+    };
+
+    using AcreDigests = std::array<uint8_t, Town::ACRE_COUNT>;
+
+    struct GoldenRow
+    {
+        uint64_t seed = 0;
+        std::vector<uint64_t> stepHashes;
+        std::vector<AcreDigests> stepAcres; // instrumentation::HashAcres after each step
+    };
+
+    // Step hashes and acre digests of a fixed seed corpus, for one generation
+    // mode and config
+    struct GoldenTable
+    {
+        GenerationMode mode = GenerationMode::LegacyV1;
+        uint64_t configHash = 0;
+        std::vector<std::string> steps;
+        std::vector<GoldenRow> rows;
+    };
+
+    const char *ModeName(GenerationMode mode)
+    {
+        return mode == GenerationMode::SubstreamsV2 ? "substreams" : "legacy";
+    }
+
+    GenerationMode ParseMode(const std::string &mode)
+    {
+        if (mode == "legacy")
+            return GenerationMode::LegacyV1;
+        if (mode == "substreams")
+            return GenerationMode::SubstreamsV2;
+        throw std::runtime_error("Unknown generation mode: " + mode);
+    }
+
+    std::string Hex(uint64_t value)
+    {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016" PRIx64, value);
+        return text;
+    }
+
+    // Enough digits to tell apart any two floats
+    std::string Exact(float value)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.9g", static_cast<double>(value));
+        return text;
+    }
+
+    const char *TileTypeName(TileType type)
+    {
+        static constexpr const char *NAMES[] = {"EMPTY", "GRASS", "DIRT", "SAND", "RIVER", "WATERFALL", "POND",
+                                                "OCEAN", "RIVER_MOUTH", "TREE", "ROCK", "BUILDING", "CLIFF", "RAMP"};
+        const auto index = static_cast<size_t>(type);
+        return index < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[index] : "?";
+    }
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: cozy_verify [--golden <file>] [--mode legacy|substreams] [--reference <dir>]\n"
+                  << "       cozy_verify --record [--golden <file>] [--mode legacy|substreams] [--start <seed>]\n"
+                  << "                   [--count <n>] [--reference <dir>]\n";
+    }
+
+    bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char *
+            {
+                if (i + 1 >= argc)
+                    throw std::runtime_error("Missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--record")
+                options.record = true;
+            else if (arg == "--golden")
+                options.goldenPath = next();
+            else if (arg == "--reference")
+                options.referenceDir = next();
+            else if (arg == "--start")
+                options.startSeed = std::stoull(next());
+            else if (arg == "--count")
+                options.count = std::stoull(next());
+            else if (arg == "--mode")
+                options.mode = ParseMode(next());
+            else if (arg == "--help" || arg == "-h")
+                return false;
+            else
+                throw std::runtime_error("Unknown argument: " + arg);
+        }
+
+        if (options.goldenPath.empty())
+            options.goldenPath = std::string(COZY_GOLDEN_DIR) + "/golden_" + ModeName(options.mode) + ".txt";
+        if (options.referenceDir.empty())
+            options.referenceDir = std::string(COZY_GOLDEN_DIR) + "/reference_" + ModeName(options.mode);
+        return true;
+    }
+
+    std::string AcresHex(const AcreDigests &digests)
+    {
+        std::string text;
+        text.reserve(2 * digests.size());
+        for (uint8_t digest : digests)
+        {
+            char hex[3];
+            std::snprintf(hex, sizeof(hex), "%02x", digest);
+            text += hex;
+        }
+        return text;
+    }
+
+    bool ParseAcresHex(const std::string &text, AcreDigests &digests)
+    {
+        if (text.size() != 2 * digests.size())
+            return false;
+        for (size_t i = 0; i < digests.size(); ++i)
+        {
+            const std::string pair = text.substr(2 * i, 2);
+            if (pair.find_first_not_of("0123456789abcdef") != std::string::npos)
+                return false;
+            digests[i] = static_cast<uint8_t>(std::stoul(pair, nullptr, 16));
+        }
+        return true;
+    }
+
+    AcreDigests ToAcreDigests(const StepStats &step)
+    {
+        AcreDigests digests{};
+        std::copy(step.acreDigests.begin(), step.acreDigests.end(), digests.begin());
+        return digests;
+    }
+
+    // Text format, one record per line:
+    //   cozy-golden 2
+    //   mode <legacy|substreams>
+    //   config <TownConfig::Hash, hex>
+    //   steps <name>...
+    //   acres <Town::ACRE_COUNT>
+    //   <seed> <layers hash after each step, hex>... <acre digests after each step>...
+    // where each acre digest field is one hex byte per acre in AcreIndex order
+    GoldenTable ReadTable(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in.is_open())
+            throw std::runtime_error("Failed to open golden table: " + path);
+
+        auto fail = [&](const std::string &why)
+        { throw std::runtime_error("Invalid golden table " + path + ": " + why); };
+
+        GoldenTable table;
+        std::string line;
+        std::string key;
+
+        int version = 0;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> key >> version) || key != TABLE_MAGIC)
+            fail("missing header");
+        if (version != TABLE_VERSION)
+            fail("unsupported version " + std::to_string(version));
+
+        std::string value;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> key >> value) || key != "mode")
+            fail("missing mode");
+        table.mode = ParseMode(value);
+
+        if (!std::getline(in, line) || !(std::istringstream(line) >> key >> value) || key != "config")
+            fail("missing config hash");
+        table.configHash = std::stoull(value, nullptr, 16);
+
+        if (!std::getline(in, line))
+            fail("missing step list");
+        std::istringstream steps(line);
+        if (!(steps >> key) || key != "steps")
+            fail("missing step list");
+        while (steps >> value)
+            table.steps.push_back(value);
+        if (table.steps.empty())
+            fail("empty step list");
+
+        int acres = 0;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> key >> acres) || key != "acres")
+            fail("missing acre count");
+        if (acres != Town::ACRE_COUNT)
+            fail("recorded for " + std::to_string(acres) + " acres, this build has " + std::to_string(Town::ACRE_COUNT));
+
+        while (std::getline(in, line))
+        {
+            if (line.empty())
+                continue;
+            std::istringstream fields(line);
+            GoldenRow row;
+            if (!(fields >> row.seed))
+                fail("bad seed in line: " + line);
+            for (size_t s = 0; s < table.steps.size() && fields >> value; ++s)
+                row.stepHashes.push_back(std::stoull(value, nullptr, 16));
+            for (size_t s = 0; s < table.steps.size() && fields >> value; ++s)
+            {
+                AcreDigests digests{};
+                if (!ParseAcresHex(value, digests))
+                    fail("bad acre digests for seed " + std::to_string(row.seed));
+                row.stepAcres.push_back(digests);
+            }
+            if (row.stepHashes.size() != table.steps.size() || row.stepAcres.size() != table.steps.size() || fields >> value)
+                fail("wrong field count for seed " + std::to_string(row.seed));
+            table.rows.push_back(std::move(row));
+        }
+        if (table.rows.empty())
+            fail("no seeds");
+        return table;
+    }
+
+    void WriteTable(const std::string &path, const GoldenTable &table)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open golden table for writing: " + path);
+
+        out << TABLE_MAGIC << ' ' << TABLE_VERSION << '\n'
+            << "mode " << ModeName(table.mode) << '\n'
+            << "config " << Hex(table.configHash) << '\n'
+            << "steps";
+        for (const std::string &step : table.steps)
+            out << ' ' << step;
+        out << '\n'
+            << "acres " << Town::ACRE_COUNT << '\n';
+
+        for (const GoldenRow &row : table.rows)
+        {
+            out << row.seed;
+            for (uint64_t hash : row.stepHashes)
+                out << ' ' << Hex(hash);
+            for (const AcreDigests &digests : row.stepAcres)
+                out << ' ' << AcresHex(digests);
+            out << '\n';
+        }
+        if (!out)
+            throw std::runtime_error("Failed to write golden table: " + path);
+    }
+
+    // Archive of the tile planes after one step, for the reference seeds
+    std::string ReferencePath(const std::string &dir, const std::string &step)
+    {
+        return dir + "/" + step + ".czta";
+    }
+
+    // Copies StepStats::planes into `town`'s tile planes
+    void CopyPlanes(const std::vector<uint8_t> &planes, Town &town)
+    {
+        const uint8_t *types = planes.data();
+        const uint8_t *elevations = types + Town::TILE_COUNT;
+        const uint8_t *autotiles = elevations + Town::TILE_COUNT;
+        for (int wz = 0; wz < Town::TILES_Z; ++wz)
+        {
+            const int start = Town::TileIndex(0, wz);
+            std::memcpy(town.MutableTypeRow(wz), types + start, Town::TILES_X);
+            std::memcpy(town.MutableElevationRow(wz), elevations + start, Town::TILES_X);
+            std::memcpy(town.MutableAutotileRow(wz), autotiles + start, Town::TILES_X);
+        }
+    }
+
+    int Record(const Options &options)
+    {
+        TownConfig config;
+        config.generationMode = options.mode;
+
+        GoldenTable table;
+        table.mode = options.mode;
+        table.configHash = config.Hash();
+        table.rows.reserve(options.count);
+
+        std::filesystem::create_directories(options.referenceDir);
+        std::vector<std::unique_ptr<io::TownArchiveWriter>> references; // One per step
+        auto stepTown = std::make_unique<Town>();
+
+        auto town = std::make_unique<Town>();
+        for (uint64_t i = 0; i < options.count; ++i)
+        {
+            const uint64_t seed = options.startSeed + i;
+            const bool reference = (i < REFERENCE_SEEDS);
+            town->Generate(seed, config, reference ? ReportLevel::Planes : ReportLevel::Acres);
+
+            GoldenRow row;
+            row.seed = seed;
+            const auto &steps = town->GetLastReport().steps;
+            for (size_t s = 0; s < steps.size(); ++s)
+            {
+                if (i == 0)
+                {
+                    table.steps.push_back(steps[s].name);
+                    references.push_back(std::make_unique<io::TownArchiveWriter>(
+                        ReferencePath(options.referenceDir, steps[s].name)));
+                }
+                row.stepHashes.push_back(steps[s].layersHash);
+                row.stepAcres.push_back(ToAcreDigests(steps[s]));
+
+                if (reference)
+                {
+                    CopyPlanes(steps[s].planes, *stepTown);
+                    stepTown->SetGenerationInfo(seed, table.configHash);
+                    references[s]->Add(*stepTown);
+                }
+            }
+            table.rows.push_back(std::move(row));
+        }
+
+        WriteTable(options.goldenPath, table);
+        std::cout << "[cozy_verify] Recorded " << table.rows.size() << " seeds (" << ModeName(options.mode)
+                  << " mode) to " << options.goldenPath << std::endl;
+
+        for (auto &reference : references)
+            reference->Finish();
+        std::cout << "[cozy_verify] Tile planes of the first " << std::min(options.count, REFERENCE_SEEDS)
+                  << " seeds written to " << options.referenceDir << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // First acre (AcreIndex order) whose digest differs after the divergent step
+    void ReportFirstAcre(const std::string &step, const AcreDigests &actual, const AcreDigests &expected)
+    {
+        int first = -1;
+        int differing = 0;
+        for (int i = 0; i < Town::ACRE_COUNT; ++i)
+        {
+            if (actual[i] == expected[i])
+                continue;
+            if (first < 0)
+                first = i;
+            ++differing;
+        }
+
+        if (first < 0)
+        {
+            std::cout << "    every acre digest after '" << step << "' matches (one-byte digests can collide)\n";
+            return;
+        }
+        std::cout << "    after '" << step << "', first divergent acre (" << first / Town::HEIGHT << ", "
+                  << first % Town::HEIGHT << "); " << differing << " of " << Town::ACRE_COUNT << " acres differ\n";
+    }
+
+    // First tile (row-major) whose planes after the divergent step differ from
+    // the reference town recorded for that step
+    void ReportFirstTile(const std::string &step, const std::vector<uint8_t> &planes, const Town &expected)
+    {
+        const uint8_t *types = planes.data();
+        const uint8_t *elevations = types + Town::TILE_COUNT;
+        const uint8_t *autotiles = elevations + Town::TILE_COUNT;
+        for (int z = 0; z < Town::TILES_Z; ++z)
+        {
+            for (int x = 0; x < Town::TILES_X; ++x)
+            {
+                const int i = Town::TileIndex(x, z);
+                const Tile want = expected.TileAt(x, z);
+                const Tile got = {static_cast<TileType>(types[i]), static_cast<int8_t>(elevations[i]), autotiles[i]};
+                if (want.type == got.type && want.elevation == got.elevation && want.autotileIndex == got.autotileIndex)
+                    continue;
+
+                std::cout << "    after '" << step << "', first divergent tile (" << x << ", " << z << ") in acre ("
+                          << x / Acre::SIZE << ", " << z / Acre::SIZE << "): type " << TileTypeName(want.type)
+                          << " -> " << TileTypeName(got.type) << ", elevation " << static_cast<int>(want.elevation)
+                          << " -> " << static_cast<int>(got.elevation) << ", autotile "
+                          << static_cast<int>(want.autotileIndex) << " -> " << static_cast<int>(got.autotileIndex) << '\n';
+                return;
+            }
+        }
+        std::cout << "    tiles after '" << step << "' match the reference (stale reference archives?)\n";
+    }
+
+    // The vector noise kernels promise bit-identical results to the scalar
+    // SmoothNoise. Golden hashes only cover the samples generation happens to
+    // take, so this also tries scattered, negative and far-off coordinates and
+    // counts that end in every vector tail length.
+    bool CheckNoiseKernels()
+    {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> coordinate(-5000.0f, 5000.0f);
+        std::uniform_int_distribution<int> cell(-2000, 2000);
+
+        std::vector<float> xs, zs, batch, row;
+        for (const int seed : {0, 1, -7, 7919, 123456789})
+        {
+            for (int count = 1; count <= 67; count += 3)
+            {
+                xs.resize(count);
+                zs.resize(count);
+                batch.resize(count);
+                row.resize(count);
+                for (int i = 0; i < count; ++i)
+                {
+                    xs[i] = coordinate(rng);
+                    zs[i] = coordinate(rng);
+                }
+
+                utils::SmoothNoiseBatch(xs.data(), zs.data(), count, seed, batch.data());
+                for (int i = 0; i < count; ++i)
+                {
+                    const float want = utils::SmoothNoise(xs[i], zs[i], seed);
+                    if (std::memcmp(&want, &batch[i], sizeof(float)) != 0)
+                    {
+                        std::cout << "[cozy_verify] SmoothNoiseBatch differs from SmoothNoise at (" << Exact(xs[i])
+                                  << ", " << Exact(zs[i]) << "), seed " << seed << ": " << Exact(batch[i])
+                                  << " != " << Exact(want) << std::endl;
+                        return false;
+                    }
+                }
+
+                const int wx0 = cell(rng);
+                const int wz = cell(rng);
+                const float scale = 0.01f + static_cast<float>(count) * 0.007f;
+                utils::SmoothNoiseRow(wx0, wz, count, scale, seed, row.data());
+                for (int i = 0; i < count; ++i)
+                {
+                    const float want = utils::SmoothNoise((wx0 + i) * scale, wz * scale, seed);
+                    if (std::memcmp(&want, &row[i], sizeof(float)) != 0)
+                    {
+                        std::cout << "[cozy_verify] SmoothNoiseRow differs from SmoothNoise at cell (" << wx0 + i
+                                  << ", " << wz << "), scale " << Exact(scale) << ", seed " << seed << ": "
+                                  << Exact(row[i]) << " != " << Exact(want) << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    int Verify(const Options &options)
+    {
+        const bool kernelsMatch = CheckNoiseKernels();
+        const GoldenTable table = ReadTable(options.goldenPath);
+
+        TownConfig config;
+        config.generationMode = table.mode;
+        if (config.Hash() != table.configHash)
+            throw std::runtime_error("TownConfig defaults changed since " + options.goldenPath +
+                                     " was recorded (config " + Hex(config.Hash()) + ", table " +
+                                     Hex(table.configHash) + "); re-record it if the change is intended");
+
+        // One archive per step; a step without one (or a tree without the
+        // directory) only loses the tile report
+        std::vector<std::unique_ptr<io::TownArchive>> references(table.steps.size());
+        for (size_t s = 0; s < table.steps.size(); ++s)
+        {
+            const std::string path = ReferencePath(options.referenceDir, table.steps[s]);
+            if (std::filesystem::exists(path))
+                references[s] = std::make_unique<io::TownArchive>(path);
+        }
+
+        auto town = std::make_unique<Town>();
+        auto expected = std::make_unique<Town>();
+        std::vector<uint64_t> firstDivergence(table.steps.size(), 0);
+        size_t divergent = 0;
+
+        for (const GoldenRow &row : table.rows)
+        {
+            town->Generate(row.seed, config, ReportLevel::Acres);
+            const auto &steps = town->GetLastReport().steps;
+            if (steps.size() != table.steps.size())
+                throw std::runtime_error("Pipeline has " + std::to_string(steps.size()) + " steps, table has " +
+                                         std::to_string(table.steps.size()));
+
+            size_t first = steps.size();
+            for (size_t s = 0; s < steps.size() && first == steps.size(); ++s)
+            {
+                if (steps[s].name != table.steps[s])
+                    throw std::runtime_error("Pipeline step " + std::to_string(s) + " is '" + steps[s].name +
+                                             "', table expects '" + table.steps[s] + "'");
+                if (steps[s].layersHash != row.stepHashes[s])
+                    first = s;
+            }
+            if (first == steps.size())
+                continue;
+
+            ++firstDivergence[first];
+            if (++divergent > MAX_REPORTED_SEEDS)
+                continue;
+
+            std::cout << "  seed " << row.seed << ": first divergent step '" << table.steps[first] << "' (expected "
+                      << Hex(row.stepHashes[first]) << ", got " << Hex(steps[first].layersHash) << ")\n";
+            ReportFirstAcre(table.steps[first], ToAcreDigests(steps[first]), row.stepAcres[first]);
+
+            const io::ArchiveEntry *entry = references[first] ? references[first]->Find(row.seed) : nullptr;
+            if (!entry)
+            {
+                std::cout << "    no reference tiles for this seed\n";
+                continue;
+            }
+            if (entry->configHash != table.configHash)
+                throw std::runtime_error("Reference archive for '" + table.steps[first] +
+                                         "' was recorded with another config; re-record it with the table");
+
+            // Only reported seeds pay for the plane copies
+            references[first]->Load(*entry, *expected);
+            town->Generate(row.seed, config, ReportLevel::Planes);
+            ReportFirstTile(table.steps[first], town->GetLastReport().steps[first].planes, *expected);
+        }
+
+        if (divergent == 0)
+        {
+            std::cout << "[cozy_verify] " << table.rows.size() << " seeds (" << ModeName(table.mode)
+                      << " mode) match " << options.goldenPath << std::endl;
+            return kernelsMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        if (divergent > MAX_REPORTED_SEEDS)
+            std::cout << "  ... and " << divergent - MAX_REPORTED_SEEDS << " more\n";
+        std::cout << "[cozy_verify] " << divergent << " of " << table.rows.size() << " seeds diverge from "
+                  << options.goldenPath << "; first divergent step:";
+        for (size_t s = 0; s < table.steps.size(); ++s)
+        {
+            if (firstDivergence[s])
+                std::cout << ' ' << table.steps[s] << '=' << firstDivergence[s];
+        }
+        std::cout << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        Options options;
+        if (!ParseOptions(argc, argv, options))
+        {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+        return options.record ? Record(options) : Verify(options);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[FATAL ERROR]: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}